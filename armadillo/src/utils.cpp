@@ -16,7 +16,7 @@ std::pair<uword,double> create_H(const double& t_0, const double& t_end, const d
 {
     double ratio = (t_end - t_0)/h;
     double remainder = std::remainder(t_end - t_0, h);
-    uword n = int(ratio) + 1; //Add one to include the initial condition
+    uword n = uword(ratio) + 1; //Add one to include the initial condition
 
     //Check if the remainder is non-zero because of floating point error
     if (remainder >= 1e-10)
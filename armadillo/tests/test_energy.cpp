@@ -0,0 +1,29 @@
+#include "../src/problems/compute.h"
+#include "../../eigen/tests/golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief 
+ * Largest energy drift max |H - H_0| of a computed matrix
+ */
+static double max_drift(const mat& Y)
+{
+    vec H = hamiltonian(Y);
+    return arma::abs(H - H[0]).max();
+}
+
+/**
+ * The energy drift of the methods that keep it bounded
+ */
+int main()
+{
+    vec y0 = create_init_cond(GOLDEN_H_0);
+
+    double drift_sv = max_drift(stormer_verlet(0, DRIFT_t_end, y0, GOLDEN_h));
+    check(drift_sv <= DRIFT_BOUND_sv, "sv energy drift " + std::to_string(drift_sv) + " within bound");
+
+    double drift_kahans = max_drift(kahans(0, DRIFT_t_end, y0, GOLDEN_h));
+    check(drift_kahans <= DRIFT_BOUND_kahans, "kahans energy drift " + std::to_string(drift_kahans) + " within bound");
+
+    return failures;
+}
@@ -0,0 +1,28 @@
+#include "../src/problems/compute.h"
+#include "../../eigen/tests/golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief 
+ * Compare the last state of a computed matrix with its golden state
+ */
+static void check_golden(const std::string& method, const mat& Y, const double* golden)
+{
+    for (uword r = 0; r < 4; r++)
+        check_close(Y(r, Y.n_cols - 1), golden[r], GOLDEN_TOLERANCE, method + " component " + std::to_string(r) + " at t_end");
+}
+
+/**
+ * Every integrator against its golden state at GOLDEN_t_end
+ */
+int main()
+{
+    vec y0 = create_init_cond(GOLDEN_H_0);
+
+    check_golden("rk4", kuttas_method(0, GOLDEN_t_end, y0, GOLDEN_h), GOLDEN_rk4);
+    check_golden("sb", shampine_bogacki(0, GOLDEN_t_end, y0, GOLDEN_h), GOLDEN_sb);
+    check_golden("kahans", kahans(0, GOLDEN_t_end, y0, GOLDEN_h), GOLDEN_kahans);
+    check_golden("sv", stormer_verlet(0, GOLDEN_t_end, y0, GOLDEN_h), GOLDEN_sv);
+
+    return failures;
+}
@@ -0,0 +1,18 @@
+#include "../src/problems/compute.h"
+#include "../../eigen/tests/golden.h"
+#include "test_utils.h"
+
+/**
+ * The number of crossings of the Poincaré section by the reference orbit, for every integrator
+ */
+int main()
+{
+    vec y0 = create_init_cond(GOLDEN_H_0);
+
+    check_close(poincare(kuttas_method(0, POINCARE_t_end, y0, GOLDEN_h)).n_cols, POINCARE_CROSSINGS, POINCARE_TOLERANCE, "rk4 crossings");
+    check_close(poincare(shampine_bogacki(0, POINCARE_t_end, y0, GOLDEN_h)).n_cols, POINCARE_CROSSINGS, POINCARE_TOLERANCE, "sb crossings");
+    check_close(poincare(kahans(0, POINCARE_t_end, y0, GOLDEN_h)).n_cols, POINCARE_CROSSINGS, POINCARE_TOLERANCE, "kahans crossings");
+    check_close(poincare(stormer_verlet(0, POINCARE_t_end, y0, GOLDEN_h)).n_cols, POINCARE_CROSSINGS, POINCARE_TOLERANCE, "sv crossings");
+
+    return failures;
+}
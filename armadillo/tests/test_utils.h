@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cmath>
+#include <iostream>
+#include <string>
+
+// Minimal checks for the regression tests, every test is a small executable
+// that prints the failed checks and returns the number of failures to CTest
+
+static int failures = 0;
+
+/**
+ * @brief 
+ * Check a condition, and report it if it does not hold
+ * 
+ * @param condition the condition
+ * @param what description of the check
+ */
+inline void check(const bool& condition, const std::string& what)
+{
+    if (!condition)
+    {
+        std::cerr << "FAILED: " << what << std::endl;
+        failures++;
+    }
+}
+
+/**
+ * @brief 
+ * Check that a value lies within tolerance of its expected value
+ * 
+ * @param value the computed value
+ * @param expected the expected value
+ * @param tolerance largest allowed (absolute) difference
+ * @param what description of the check
+ */
+inline void check_close(const double& value, const double& expected, const double& tolerance, const std::string& what)
+{
+    bool close = std::abs(value - expected) <= tolerance;
+    if (!close)
+        std::cerr << what << ": " << value << ", expected " << expected << " +- " << tolerance << std::endl;
+    check(close, what);
+}
@@ -1,4 +1,7 @@
-#include "./src/problems/compute.h"
+#include "./src/problems/benchmark.h"
+#include "./src/problems/ensemble.h"
+#include "./src/problems/escape.h"
+#include "./src/problems/pipeline.h"
 #include "./src/constants.h"
 
 
@@ -22,14 +25,58 @@
  * the process of storing the data to a CSV file.
  */
 
+/**
+ * Run with "benchmark" as the argument (./hhp benchmark) to compute
+ * the work-precision table of all methods instead, see
+ * ./src/problems/benchmark.h
+ *
+ * Run with "escape" as the argument (./hhp escape) to compute
+ * the escape basins above the threshold energy instead, see
+ * ./src/problems/escape.h
+ *
+ * Run with "ensemble", a binary file of initial conditions, and optionally
+ * the number of values in each row (4, or 6 with h and t_end) and the method
+ * (./hhp ensemble ic.bin 6 sv) to integrate an ensemble instead, see
+ * ./src/problems/ensemble.h
+ */
+
+#include <cstdlib>
+#include <cstring>
 #include <iostream> 
 
-int main()
+int main(int argc, char** argv)
 {
     Array<double, 4, 1> y0 = create_init_cond(H_0);
+
+    if (argc > 1 && !std::strcmp(argv[1], "benchmark"))
+    {
+        compute_work_precision(t_0, bench_t_end, y0);
+        return 0;
+    }
+
+    if (argc > 1 && !std::strcmp(argv[1], "escape"))
+    {
+        compute_escape_basin(escape_H_0, escape_h, escape_t_max, escape_n_q2, escape_n_p2);
+        return 0;
+    }
+
+    if (argc > 2 && !std::strcmp(argv[1], "ensemble"))
+    {
+        int width = (argc > 3) ? std::atoi(argv[3]) : 4;
+        std::string method = (argc > 4) ? argv[4] : "sv";
+        compute_ensemble(method, argv[2], width, t_0, ensemble_t_end, ensemble_h);
+        return 0;
+    }
+
+    //Write the progress of the runs to telemetry_file while they are computed (see ./src/telemetry.h)
+    start_telemetry();
+
     //compute_hamiltonians(t_0, t_end, y0, h);
     //compute_poincare_maps(t_0, t_end, y0, h);
+    //compute_pipelined(t_0, t_end, y0, h);
     compute_both(t_0, t_end, y0, h);
 
+    stop_telemetry();
+
     return 0;
 }
\ No newline at end of file
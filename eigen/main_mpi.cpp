@@ -0,0 +1,40 @@
+#include "./src/distributed/sweep.h"
+#include "./src/constants.h"
+
+#include <cstdlib>
+#include <iostream>
+
+
+/**
+ * Sweep over the step sizes, energies and initial conditions
+ * in ./src/constants.h, distributed over MPI ranks
+ * 
+ * Run with e.g.
+ * mpirun -np 5 ./hhp_mpi (rank 0 only hands out jobs)
+ * 
+ * The end time of the jobs (sweep_t_end) can be given as the first argument,
+ * e.g. mpirun -np 5 ./hhp_mpi 1000 for a short run
+ * 
+ * Each rank computes its jobs with OpenMP, so set
+ * OMP_NUM_THREADS to the number of cores per rank
+ */
+
+int main(int argc, char** argv)
+{
+    //Only the main thread of each rank communicates, which MPI has to allow while the OpenMP threads run
+    int provided;
+    MPI_Init_thread(&argc, &argv, MPI_THREAD_FUNNELED, &provided);
+    if (provided < MPI_THREAD_FUNNELED)
+    {
+        std::cerr << "hhp_mpi: the MPI library does not provide MPI_THREAD_FUNNELED" << std::endl;
+        MPI_Abort(MPI_COMM_WORLD, 1);
+    }
+
+    double t_end = (argc > 1) ? std::atof(argv[1]) : sweep_t_end;
+
+    compute_sweep(t_0, t_end);
+
+    MPI_Finalize();
+
+    return 0;
+}
@@ -0,0 +1,276 @@
+#include "cache.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <cstring>
+#include <fcntl.h>
+#include <filesystem>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <vector>
+
+//Written at the start of every cache file, bump the digit if the layout changes
+static const char CACHE_MAGIC[8] = {'H', 'H', 'P', 'C', 'A', 'C', 'H', '1'};
+
+//Hash of the sources of the methods and analyses, set by CMake (see src/CMakeLists.txt)
+#ifndef HHP_CODE_VERSION
+#define HHP_CODE_VERSION "unknown"
+#endif
+
+//The header of a cache file, followed by the key and padded to CACHE_HEADER_BYTES
+struct CacheHeader
+{
+    char magic[8];
+    std::uint64_t key_bytes;
+    std::int64_t rows;
+    std::int64_t cols;
+};
+
+/**
+ * @brief
+ * Append a plain value to a key
+ */
+template <typename T>
+static void append_value(std::string& key, const T& value)
+{
+    key.append(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief
+ * The key of a result, everything the result depends on.
+ * Results of different instruction sets or compilers may round differently, and results of
+ * other versions of the code may differ, so they are kept apart
+ *
+ * @param kind what the result is, e.g. "trajectory", "hamiltonian" or "poincare"
+ * @param method name of the integrator
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @return std::string the key
+ */
+std::string cache_key(const std::string& kind, const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    std::string key = kind + '\0' + method + '\0' + isa_name(active_isa()) + '\0' + __VERSION__ + '\0' + HHP_CODE_VERSION + '\0';
+
+    append_value(key, t_0);
+    append_value(key, t_end);
+    append_value(key, h);
+    for (int i = 0; i < 4; i++)
+        append_value(key, y0[i]);
+    append_value(key, SKIP_STORAGE);
+
+    return key;
+}
+
+/**
+ * @brief
+ * Path of the cache file of a key, named by the 64 bit FNV-1a hash of the key
+ */
+static std::string cache_path(const std::string& key)
+{
+    std::uint64_t hash = 14695981039346656037ull;
+    for (unsigned char c : key)
+    {
+        hash ^= c;
+        hash *= 1099511628211ull;
+    }
+
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016llx.bin", (unsigned long long)hash);
+
+    return cache_dir + "/" + name;
+}
+
+/**
+ * @brief
+ * Map a result from the cache into memory, read only, and mark it as recently used
+ *
+ * @param key the key of the result (see cache_key)
+ * @param C filled with the mapped matrix (release it with cache_release)
+ * @return true if the result was in the cache
+ */
+bool cache_load(const std::string& key, CachedMatrix& C)
+{
+    if (CACHE_MAX_BYTES <= 0)
+        return false;
+
+    std::string path = cache_path(key);
+    int fd = open(path.c_str(), O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    //The file must belong to this exact key (not just its hash), and be complete
+    struct stat st;
+    CacheHeader header;
+    std::string stored(key.size(), '\0');
+    bool valid = fstat(fd, &st) == 0
+        && pread(fd, &header, sizeof(header), 0) == sizeof(header)
+        && !std::memcmp(header.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC))
+        && header.key_bytes == key.size()
+        && pread(fd, stored.data(), key.size(), sizeof(header)) == std::int64_t(key.size())
+        && stored == key
+        && header.rows >= 0 && header.cols >= 0
+        && std::size_t(st.st_size) == CACHE_HEADER_BYTES + std::size_t(header.rows*header.cols)*sizeof(double);
+
+    if (!valid)
+    {
+        close(fd);
+        return false;
+    }
+
+    void* p = mmap(nullptr, std::size_t(st.st_size), PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (p == MAP_FAILED)
+        return false;
+
+    //The modification time orders the files for eviction
+    utimensat(AT_FDCWD, path.c_str(), nullptr, 0);
+
+    C.data = reinterpret_cast<const double*>(static_cast<const char*>(p) + CACHE_HEADER_BYTES);
+    C.rows = header.rows;
+    C.cols = header.cols;
+    C.mapping = p;
+    C.bytes = std::size_t(st.st_size);
+
+    return true;
+}
+
+/**
+ * @brief
+ * Unmap a result of cache_load
+ *
+ * @param C the mapped matrix
+ */
+void cache_release(CachedMatrix& C)
+{
+    if (C.mapping)
+        munmap(C.mapping, C.bytes);
+
+    C = CachedMatrix();
+}
+
+/**
+ * @brief
+ * Remove the least recently used cache files until the cache is no larger than CACHE_MAX_BYTES.
+ * A removed file stays valid for the runs that have mapped it
+ *
+ * @param keep path of a file that is never removed (the one just stored)
+ */
+static void evict(const std::string& keep)
+{
+    struct CacheFile
+    {
+        std::filesystem::file_time_type used;
+        std::uintmax_t bytes;
+        std::filesystem::path path;
+    };
+
+    std::vector<CacheFile> files;
+    std::uintmax_t total = 0;
+
+    std::error_code ec;
+    for (const auto& entry : std::filesystem::directory_iterator(cache_dir, ec))
+    {
+        if (!entry.is_regular_file(ec) || entry.path().extension() != ".bin")
+            continue;
+
+        CacheFile f{entry.last_write_time(ec), entry.file_size(ec), entry.path()};
+        if (ec)
+            continue;
+
+        total += f.bytes;
+        files.push_back(f);
+    }
+
+    if (total <= std::uintmax_t(CACHE_MAX_BYTES))
+        return;
+
+    std::sort(files.begin(), files.end(), [](const CacheFile& a, const CacheFile& b) { return a.used < b.used; });
+
+    for (const CacheFile& f : files)
+    {
+        if (total <= std::uintmax_t(CACHE_MAX_BYTES))
+            break;
+        if (f.path == keep)
+            continue;
+
+        if (std::filesystem::remove(f.path, ec))
+            total -= f.bytes;
+    }
+}
+
+/**
+ * @brief
+ * Store a result in the cache, and evict old results if the cache grew too large.
+ * Results larger than CACHE_MAX_BYTES are not stored
+ *
+ * @param key the key of the result (see cache_key)
+ * @param M the result
+ */
+void cache_store(const std::string& key, const Ref<const Matrix<double, Dynamic, Dynamic>> M)
+{
+    std::size_t bytes = CACHE_HEADER_BYTES + std::size_t(M.size())*sizeof(double);
+    if (CACHE_MAX_BYTES <= 0 || bytes > std::size_t(CACHE_MAX_BYTES) || sizeof(CacheHeader) + key.size() > CACHE_HEADER_BYTES)
+        return;
+
+    std::error_code ec;
+    std::filesystem::create_directories(cache_dir, ec);
+
+    //Written next to the final file and renamed over it, so no run ever maps half a file
+    std::string path = cache_path(key);
+    std::string tmp = path + "." + std::to_string(getpid()) + ".tmp";
+
+    std::FILE* out = std::fopen(tmp.c_str(), "wb");
+    if (!out)
+        return;
+
+    std::vector<char> header(CACHE_HEADER_BYTES, 0);
+    CacheHeader h;
+    std::memcpy(h.magic, CACHE_MAGIC, sizeof(CACHE_MAGIC));
+    h.key_bytes = key.size();
+    h.rows = M.rows();
+    h.cols = M.cols();
+    std::memcpy(header.data(), &h, sizeof(h));
+    std::memcpy(header.data() + sizeof(h), key.data(), key.size());
+
+    bool written = std::fwrite(header.data(), 1, header.size(), out) == header.size();
+    if (M.outerStride() == M.rows())
+        written = written && std::fwrite(M.data(), sizeof(double), M.size(), out) == std::size_t(M.size());
+    else
+        for (Eigen::Index j = 0; j < M.cols(); j++)
+            written = written && std::fwrite(M.col(j).data(), sizeof(double), M.rows(), out) == std::size_t(M.rows());
+    written = (std::fclose(out) == 0) && written;
+
+    if (!written || std::rename(tmp.c_str(), path.c_str()) != 0)
+    {
+        std::remove(tmp.c_str());
+        return;
+    }
+
+    evict(path);
+}
+
+/**
+ * @brief
+ * Copy a cached column (e.g. a hamiltonian) into a, if it has the same length
+ *
+ * @param key the key of the result (see cache_key)
+ * @param a filled with the result
+ * @return true if the result was in the cache
+ */
+bool cache_copy(const std::string& key, Ref<Array<double, Dynamic, 1>> a)
+{
+    CachedMatrix C;
+    if (!cache_load(key, C))
+        return false;
+
+    bool found = (C.rows == a.size() && C.cols == 1);
+    if (found)
+        a = Eigen::Map<const Array<double, Dynamic, 1>>(C.data, C.rows);
+    cache_release(C);
+
+    return found;
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <string>
+
+#include "utils.h"
+
+// Cache of computed trajectories and analysis results on disk, off unless CACHE_MAX_BYTES is set
+// A result is stored in cache_dir under the hash of everything it depends on (its kind, the method,
+// h, t_0, t_end, y0, SKIP_STORAGE, the instruction set of the kernels, the compiler and the code version),
+// so a later run with the same parameters maps the file into memory instead of computing it again.
+// The code version is a hash of the sources of the methods and analyses, computed by CMake when it
+// configures the build (HHP_CODE_VERSION), so changing a method never reuses its old results.
+// The key is stored in the file too, and checked when it is opened. The files are written to a
+// temporary file that is renamed, so concurrent runs never see half a file. Opening a file marks it
+// as used, and when the cache grows past CACHE_MAX_BYTES the least recently used files are removed
+
+//The data of a cache file starts at this offset, so it is page aligned in the mapping
+constexpr std::size_t CACHE_HEADER_BYTES = 4096;
+
+//A matrix mapped from a cache file, read only
+struct CachedMatrix
+{
+    const double* data = nullptr;
+    std::int64_t rows = 0;
+    std::int64_t cols = 0;
+    void* mapping = nullptr;
+    std::size_t bytes = 0;
+};
+
+//A result that was either computed, or mapped from the cache
+template <int Rows>
+struct CachedResult
+{
+    Matrix<double, Rows, Dynamic> computed;
+    CachedMatrix mapped;
+
+    Eigen::Map<const Matrix<double, Rows, Dynamic>> view() const
+    {
+        if (mapped.data)
+            return Eigen::Map<const Matrix<double, Rows, Dynamic>>(mapped.data, Rows, mapped.cols);
+        return Eigen::Map<const Matrix<double, Rows, Dynamic>>(computed.data(), Rows, computed.cols());
+    }
+};
+
+std::string cache_key(const std::string& kind, const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+bool cache_load(const std::string& key, CachedMatrix& C);
+void cache_release(CachedMatrix& C);
+void cache_store(const std::string& key, const Ref<const Matrix<double, Dynamic, Dynamic>> M);
+bool cache_copy(const std::string& key, Ref<Array<double, Dynamic, 1>> a);
+
+/**
+ * @brief
+ * Copy a (small) result from the cache, e.g. a Poincaré map
+ *
+ * @param key the key of the result (see cache_key)
+ * @param M resized and filled with the result
+ * @return true if the result was in the cache
+ */
+template <int Rows>
+bool cache_copy(const std::string& key, Matrix<double, Rows, Dynamic>& M)
+{
+    CachedMatrix C;
+    if (!cache_load(key, C))
+        return false;
+
+    bool found = (C.rows == Rows);
+    if (found)
+        M = Eigen::Map<const Matrix<double, Rows, Dynamic>>(C.data, Rows, C.cols);
+    cache_release(C);
+
+    return found;
+}
+
+/**
+ * @brief
+ * Free a result, computed or mapped
+ *
+ * @param R the result
+ */
+template <int Rows>
+void release_result(CachedResult<Rows>& R)
+{
+    R.computed = Matrix<double, Rows, Dynamic>();
+    cache_release(R.mapped);
+}
+
+/**
+ * @brief
+ * Map a result from the cache, or compute it (store it with store_result)
+ *
+ * @param R the result
+ * @param key the key of the result (see cache_key)
+ * @param compute Computes the result, compute()
+ * @param use_cache look for the result in the cache, or always compute it
+ */
+template <int Rows, typename Compute>
+void cached_result(CachedResult<Rows>& R, const std::string& key, Compute compute, const bool& use_cache)
+{
+    if (use_cache && cache_load(key, R.mapped))
+    {
+        if (R.mapped.rows == Rows)
+            return;
+        cache_release(R.mapped);
+    }
+
+    R.computed = compute();
+}
+
+/**
+ * @brief
+ * Store a result of cached_result in the cache, unless it was mapped from it
+ *
+ * @param R the result
+ * @param key the key of the result (see cache_key)
+ */
+template <int Rows>
+void store_result(const CachedResult<Rows>& R, const std::string& key)
+{
+    if (!R.mapped.data)
+        cache_store(key, R.computed);
+}
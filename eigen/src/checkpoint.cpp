@@ -0,0 +1,236 @@
+#include "checkpoint.h"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+
+//Written at the start of every checkpoint file, bump the digit if the layout changes
+static const char CHECKPOINT_MAGIC[8] = {'H', 'H', 'P', 'C', 'K', 'P', 'T', '2'};
+
+/**
+ * @brief
+ * Write a plain value to a binary stream
+ */
+template <typename T>
+static void write_value(std::ostream& out, const T& value)
+{
+    out.write(reinterpret_cast<const char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief
+ * Read a plain value from a binary stream
+ */
+template <typename T>
+static void read_value(std::istream& in, T& value)
+{
+    in.read(reinterpret_cast<char*>(&value), sizeof(T));
+}
+
+/**
+ * @brief
+ * Iterations between checkpoints, CHECKPOINT_INTERVAL unless HHP_CHECKPOINT_INTERVAL is set
+ *
+ * @return int the interval, 0 or less if checkpointing is disabled
+ */
+static int checkpoint_interval()
+{
+    const char* requested = std::getenv("HHP_CHECKPOINT_INTERVAL");
+    if (requested && *requested)
+        return std::atoi(requested);
+
+    return CHECKPOINT_INTERVAL;
+}
+
+/**
+ * @brief
+ * Create an (empty) checkpoint for a run, describing the run it belongs to
+ *
+ * @param file path of the checkpoint file, an empty path disables checkpointing
+ * @param method name of the integrator, so different methods never resume each other
+ *               (the instruction set of the kernels is added to it)
+ * @param t_0 start time
+ * @param t_end end time
+ * @param h length of timestep
+ * @param y0 initial condition
+ * @param skip_storage SKIP_STORAGE used by the run
+ * @param m number of columns stored by the run
+ * @return Checkpoint
+ */
+Checkpoint create_checkpoint(const std::string& file, const std::string& method, const double& t_0, const double& t_end, const double& h, const Ref<const Array<double, 4, 1>> y0, const int& skip_storage, const std::int64_t& m)
+{
+    Checkpoint cp;
+    cp.file = file;
+    //Different instruction sets may round differently, so they never resume each other either
+    cp.method = method + "/" + isa_name(active_isa());
+    cp.t_0 = t_0;
+    cp.t_end = t_end;
+    cp.h = h;
+    cp.y0 = y0;
+    cp.skip_storage = skip_storage;
+    cp.m = m;
+
+    cp.step = 0;
+    cp.storage_index = 1;
+    cp.y_curr = y0;
+    cp.carry = Array<double, 2, 1>::Zero();
+
+    //Never reached if checkpointing is disabled
+    cp.interval = file.empty() ? 0 : checkpoint_interval();
+    cp.next_step = (cp.interval <= 0) ? INT64_MAX : cp.interval;
+    cp.cols_written = 0;
+
+    return cp;
+}
+
+/**
+ * @brief
+ * Try to resume a run from its checkpoint. The checkpoint is only used if
+ * it was written by the exact same run (method, times, step size, initial condition and storage).
+ * On success the state in cp and the first cp.storage_index columns of Y are restored
+ *
+ * @param cp checkpoint created with create_checkpoint
+ * @param Y matrix the run stores its values in
+ * @return true if the run was restored and should continue from iteration cp.step + 1
+ */
+bool load_checkpoint(Checkpoint& cp, Ref<Matrix<double, 4, Dynamic>> Y)
+{
+    if (cp.next_step == INT64_MAX)
+        return false;
+
+    std::ifstream state(cp.file, std::ios::binary);
+    if (!state)
+        return false;
+
+    char magic[8];
+    state.read(magic, sizeof(magic));
+    if (!state || std::memcmp(magic, CHECKPOINT_MAGIC, sizeof(magic)))
+        return false;
+
+    //Identity of the run that wrote the checkpoint
+    unsigned int method_length = 0;
+    read_value(state, method_length);
+    if (!state || method_length != cp.method.size())
+        return false;
+    std::string method(method_length, ' ');
+    state.read(&method[0], method_length);
+
+    double t_0, t_end, h;
+    Array<double, 4, 1> y0;
+    int skip_storage;
+    std::int64_t m;
+    read_value(state, t_0);
+    read_value(state, t_end);
+    read_value(state, h);
+    state.read(reinterpret_cast<char*>(y0.data()), 4*sizeof(double));
+    read_value(state, skip_storage);
+    read_value(state, m);
+
+    //Compare bitwise, a checkpoint of a slightly different run must never be resumed
+    if (!state || method != cp.method
+        || std::memcmp(&t_0, &cp.t_0, sizeof(double)) || std::memcmp(&t_end, &cp.t_end, sizeof(double))
+        || std::memcmp(&h, &cp.h, sizeof(double)) || std::memcmp(y0.data(), cp.y0.data(), 4*sizeof(double))
+        || skip_storage != cp.skip_storage || m != cp.m)
+        return false;
+
+    //State of the integrator
+    std::int64_t step, storage_index;
+    Array<double, 4, 1> y_curr;
+    Array<double, 2, 1> carry;
+    read_value(state, step);
+    read_value(state, storage_index);
+    state.read(reinterpret_cast<char*>(y_curr.data()), 4*sizeof(double));
+    state.read(reinterpret_cast<char*>(carry.data()), 2*sizeof(double));
+    if (!state || storage_index < 1 || storage_index > Y.cols())
+        return false;
+
+    //The stored columns, the file may contain more columns than the state refers to
+    //if the run was killed between appending them and replacing the state
+    std::string cols_file = cp.file + ".cols";
+    std::ifstream cols(cols_file, std::ios::binary);
+    for (std::int64_t j = 0; j < storage_index && cols; j++)
+        cols.read(reinterpret_cast<char*>(Y.col(j).data()), 4*sizeof(double));
+    if (!cols)
+        return false;
+    cols.close();
+    std::filesystem::resize_file(cols_file, std::uintmax_t(storage_index)*4*sizeof(double));
+
+    cp.step = step;
+    cp.storage_index = storage_index;
+    cp.y_curr = y_curr;
+    cp.carry = carry;
+    cp.next_step = (step > INT64_MAX - cp.interval) ? INT64_MAX : step + cp.interval;
+    cp.cols_written = storage_index;
+
+    return true;
+}
+
+/**
+ * @brief
+ * Write the current state of a run to its checkpoint.
+ * The columns stored since the last checkpoint are appended first, and the state file
+ * is then replaced atomically, so a run killed at any point leaves a usable checkpoint
+ *
+ * @param cp checkpoint with step, storage_index, y_curr (and carry) set to the current state
+ * @param Y matrix the run stores its values in
+ */
+void save_checkpoint(Checkpoint& cp, const Ref<const Matrix<double, 4, Dynamic>> Y)
+{
+    //Append the new columns, or start over if nothing of this run is on disk yet
+    std::string cols_file = cp.file + ".cols";
+    std::ofstream cols(cols_file, std::ios::binary | (cp.cols_written ? std::ios::app : std::ios::trunc));
+    for (std::int64_t j = cp.cols_written; j < cp.storage_index; j++)
+        cols.write(reinterpret_cast<const char*>(Y.col(j).data()), 4*sizeof(double));
+    cols.close();
+
+    //The old state still refers to the columns before the failed append, so keep it, drop the
+    //partial columns and try again at the next checkpoint
+    cp.next_step = (cp.step > INT64_MAX - cp.interval) ? INT64_MAX : cp.step + cp.interval;
+    if (!cols)
+    {
+        std::error_code ec;
+        std::filesystem::resize_file(cols_file, std::uintmax_t(cp.cols_written)*4*sizeof(double), ec);
+        return;
+    }
+    cp.cols_written = cp.storage_index;
+
+    //Write the state next to the checkpoint, and rename it over the old one
+    std::string tmp_file = cp.file + ".tmp";
+    std::ofstream state(tmp_file, std::ios::binary | std::ios::trunc);
+    state.write(CHECKPOINT_MAGIC, sizeof(CHECKPOINT_MAGIC));
+    write_value(state, (unsigned int)cp.method.size());
+    state.write(cp.method.data(), cp.method.size());
+    write_value(state, cp.t_0);
+    write_value(state, cp.t_end);
+    write_value(state, cp.h);
+    state.write(reinterpret_cast<const char*>(cp.y0.data()), 4*sizeof(double));
+    write_value(state, cp.skip_storage);
+    write_value(state, cp.m);
+    write_value(state, cp.step);
+    write_value(state, cp.storage_index);
+    state.write(reinterpret_cast<const char*>(cp.y_curr.data()), 4*sizeof(double));
+    state.write(reinterpret_cast<const char*>(cp.carry.data()), 2*sizeof(double));
+    state.close();
+
+    //Only replace the old checkpoint if the new one was written completely
+    if (state)
+        std::rename(tmp_file.c_str(), cp.file.c_str());
+}
+
+/**
+ * @brief
+ * Remove the checkpoint of a finished run
+ *
+ * @param cp checkpoint of the run
+ */
+void remove_checkpoint(const Checkpoint& cp)
+{
+    if (cp.interval <= 0)
+        return;
+
+    std::remove(cp.file.c_str());
+    std::remove((cp.file + ".cols").c_str());
+    std::remove((cp.file + ".tmp").c_str());
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <string>
+
+#include "utils.h"
+
+// Checkpoint/restart of long integrations
+// The state of a running integrator is written to a small binary file (atomically replaced),
+// while the columns stored so far are appended to a separate file next to it (file + ".cols").
+// A run started with a matching checkpoint on disk continues where it was killed, bit-for-bit.
+// The environment variable HHP_CHECKPOINT_INTERVAL overrides CHECKPOINT_INTERVAL without a rebuild.
+
+struct Checkpoint
+{
+    //Identity of the run, a checkpoint is only resumed if all of these match
+    std::string file;
+    std::string method;
+    double t_0;
+    double t_end;
+    double h;
+    Array<double, 4, 1> y0;
+    int skip_storage;
+    std::int64_t m;
+
+    //State of the integrator after iteration "step"
+    std::int64_t step;
+    std::int64_t storage_index;
+    Array<double, 4, 1> y_curr;
+    Array<double, 2, 1> carry;      //q_next of Störmer-Verlet, unused by the other methods
+
+    //Iterations between checkpoints, the iteration at which the next one is written,
+    //and the number of columns already on disk
+    int interval;
+    std::int64_t next_step;
+    std::int64_t cols_written;
+};
+
+Checkpoint create_checkpoint(const std::string& file, const std::string& method, const double& t_0, const double& t_end, const double& h, const Ref<const Array<double, 4, 1>> y0, const int& skip_storage, const std::int64_t& m);
+bool load_checkpoint(Checkpoint& cp, Ref<Matrix<double, 4, Dynamic>> Y);
+void save_checkpoint(Checkpoint& cp, const Ref<const Matrix<double, 4, Dynamic>> Y);
+void remove_checkpoint(const Checkpoint& cp);
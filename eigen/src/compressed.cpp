@@ -0,0 +1,381 @@
+#include "compressed.h"
+
+#include <cstring>
+
+//Written at the start of every compressed file, bump the digit if the layout changes
+static const char COMPRESSED_MAGIC[8] = {'H', 'H', 'P', 'C', 'T', 'R', 'J', '1'};
+
+//Highest order of the polynomial extrapolation used to predict values
+constexpr int MAX_PREDICTION_ORDER = 4;
+
+/**
+ * @brief 
+ * The bits of a double as an integer
+ */
+static std::uint64_t to_bits(const double& x)
+{
+    std::uint64_t u;
+    std::memcpy(&u, &x, sizeof(u));
+    return u;
+}
+
+/**
+ * @brief 
+ * The double with the given bits
+ */
+static double from_bits(const std::uint64_t& u)
+{
+    double x;
+    std::memcpy(&x, &u, sizeof(x));
+    return x;
+}
+
+/**
+ * @brief 
+ * Predict x[j] by extrapolating the polynomial through the previous values.
+ * The expressions are written out so the encoder and decoder round exactly the same way
+ * (this file is compiled without FMA contraction)
+ * 
+ * @param x values of the row
+ * @param j index of the value to predict
+ * @param order order of the polynomial (lowered at the start of the row)
+ * @return double the prediction
+ */
+static double predict(const double* x, const int& j, const int& order)
+{
+    switch (std::min(order, j))
+    {
+        case 0:  return 0;
+        case 1:  return x[j-1];
+        case 2:  return 2*x[j-1] - x[j-2];
+        case 3:  return 3*x[j-1] - 3*x[j-2] + x[j-3];
+        default: return 4*x[j-1] - 6*x[j-2] + 4*x[j-3] - x[j-4];
+    }
+}
+
+/**
+ * @brief 
+ * Difference between the bits of a value and its prediction,
+ * zigzag encoded so small negative differences have few significant bytes too
+ */
+static std::uint64_t residual(const double& x, const double& prediction)
+{
+    std::uint64_t d = to_bits(x) - to_bits(prediction);
+    return (d << 1) ^ (0 - (d >> 63));
+}
+
+/**
+ * @brief 
+ * The value from its prediction and residual (inverse of residual())
+ */
+static double from_residual(const std::uint64_t& z, const double& prediction)
+{
+    std::uint64_t d = (z >> 1) ^ (0 - (z & 1));
+    return from_bits(to_bits(prediction) + d);
+}
+
+/**
+ * @brief 
+ * Number of bytes needed to store a residual
+ */
+static int significant_bytes(std::uint64_t z)
+{
+    int n = 0;
+    for (; z; z >>= 8)
+        n++;
+    return n;
+}
+
+/**
+ * @brief 
+ * Compress one row of a block, with the prediction order that gives the smallest output
+ * 
+ * @param x values of the row
+ * @param cols number of values
+ * @param out compressed data is appended here
+ */
+static void compress_row(const double* x, const int& cols, std::vector<unsigned char>& out)
+{
+    //Find the best prediction order for this row
+    int order = 1;
+    long best_size = -1;
+    for (int o = 1; o <= MAX_PREDICTION_ORDER; o++)
+    {
+        long size = 0;
+        for (int j = 0; j < cols; j++)
+            size += significant_bytes(residual(x[j], predict(x, j, o)));
+
+        if (best_size < 0 || size < best_size)
+        {
+            best_size = size;
+            order = o;
+        }
+    }
+
+    //The order, then the number of bytes of each residual (two per byte), then the residuals
+    std::size_t start = out.size();
+    out.resize(start + 1 + (cols + 1)/2 + best_size, 0);
+    unsigned char* lengths = &out[start + 1];
+    unsigned char* payload = lengths + (cols + 1)/2;
+
+    out[start] = (unsigned char)order;
+    for (int j = 0; j < cols; j++)
+    {
+        std::uint64_t z = residual(x[j], predict(x, j, order));
+        int n = significant_bytes(z);
+
+        lengths[j/2] |= (unsigned char)(n << (4*(j % 2)));
+        for (int k = 0; k < n; k++, z >>= 8)
+            *payload++ = (unsigned char)(z & 0xff);
+    }
+}
+
+/**
+ * @brief 
+ * Decompress one row of a block
+ * 
+ * @param in compressed data of the row
+ * @param cols number of values
+ * @param x the decompressed values
+ * @return const unsigned char* the compressed data after the row
+ */
+static const unsigned char* decompress_row(const unsigned char* in, const int& cols, double* x)
+{
+    int order = in[0];
+    const unsigned char* lengths = in + 1;
+    const unsigned char* payload = lengths + (cols + 1)/2;
+
+    for (int j = 0; j < cols; j++)
+    {
+        int n = (lengths[j/2] >> (4*(j % 2))) & 0xf;
+
+        std::uint64_t z = 0;
+        for (int k = 0; k < n; k++)
+            z |= std::uint64_t(*payload++) << (8*k);
+
+        x[j] = from_residual(z, predict(x, j, order));
+    }
+
+    return payload;
+}
+
+/**
+ * @brief 
+ * Decompress a block from its compressed data
+ * 
+ * @param in compressed data of the block
+ * @param cols number of columns of the block
+ * @param Y the first cols columns are filled with the block
+ */
+static void decompress_data(const unsigned char* in, const int& cols, Ref<Matrix<double, 4, Dynamic>> Y)
+{
+    std::vector<double> x(cols);
+    for (int r = 0; r < 4; r++)
+    {
+        in = decompress_row(in, cols, x.data());
+        for (int j = 0; j < cols; j++)
+            Y(r, j) = x[j];
+    }
+}
+
+/**
+ * @brief 
+ * Compress the columns of Y and append them to C as a new block.
+ * Integrators can call this for each block of columns as they are computed,
+ * so the whole matrix never has to be stored uncompressed
+ * 
+ * @param C the compressed matrix
+ * @param Y columns to append (at most COMPRESSED_BLOCK)
+ */
+void compress_block(CompressedTrajectory& C, const Ref<const Matrix<double, 4, Dynamic>> Y)
+{
+    if (C.offsets.empty())
+    {
+        C.offsets.push_back(0);
+        C.starts.push_back(0);
+    }
+
+    int cols = int(Y.cols());
+    std::vector<double> x(cols);
+    for (int r = 0; r < 4; r++)
+    {
+        for (int j = 0; j < cols; j++)
+            x[j] = Y(r, j);
+        compress_row(x.data(), cols, C.data);
+    }
+
+    C.offsets.push_back(C.data.size());
+    C.starts.push_back(C.starts.back() + cols);
+}
+
+/**
+ * @brief 
+ * Compress a whole matrix
+ * 
+ * @param Y the matrix
+ * @return CompressedTrajectory 
+ */
+CompressedTrajectory compress(const Ref<const Matrix<double, 4, Dynamic>> Y)
+{
+    CompressedTrajectory C;
+    for (Eigen::Index j = 0; j < Y.cols(); j += COMPRESSED_BLOCK)
+        compress_block(C, Y.middleCols(j, std::min<Eigen::Index>(COMPRESSED_BLOCK, Y.cols() - j)));
+
+    return C;
+}
+
+/**
+ * @brief 
+ * Number of blocks in a compressed matrix
+ */
+int compressed_blocks(const CompressedTrajectory& C)
+{
+    return C.offsets.empty() ? 0 : int(C.offsets.size()) - 1;
+}
+
+/**
+ * @brief 
+ * Number of columns in a compressed matrix
+ */
+std::int64_t compressed_cols(const CompressedTrajectory& C)
+{
+    return C.starts.empty() ? 0 : C.starts.back();
+}
+
+/**
+ * @brief 
+ * Decompress a single block
+ * 
+ * @param C the compressed matrix
+ * @param block index of the block
+ * @param Y filled with the columns of the block, must have at least as many columns as the block
+ * @return int number of columns in the block
+ */
+int decompress_block(const CompressedTrajectory& C, const int& block, Ref<Matrix<double, 4, Dynamic>> Y)
+{
+    int cols = int(C.starts[block+1] - C.starts[block]);
+    decompress_data(&C.data[C.offsets[block]], cols, Y);
+
+    return cols;
+}
+
+/**
+ * @brief 
+ * Decompress a whole matrix
+ * 
+ * @param C the compressed matrix
+ * @return Matrix<double, 4, Dynamic> 
+ */
+Matrix<double, 4, Dynamic> decompress(const CompressedTrajectory& C)
+{
+    Matrix<double, 4, Dynamic> Y(4, compressed_cols(C));
+    for (int b = 0; b < compressed_blocks(C); b++)
+        decompress_block(C, b, Y.middleCols(C.starts[b], C.starts[b+1] - C.starts[b]));
+
+    return Y;
+}
+
+/**
+ * @brief 
+ * Save a compressed matrix to a binary file: a header with the
+ * block index, followed by the compressed blocks
+ * 
+ * @param filename file name
+ * @param C the compressed matrix
+ */
+void save_compressed(const std::string& filename, const CompressedTrajectory& C)
+{
+    std::uint64_t n_blocks = compressed_blocks(C);
+
+    std::ofstream file(filename, std::ios::binary | std::ios::trunc);
+    file.write(COMPRESSED_MAGIC, sizeof(COMPRESSED_MAGIC));
+    file.write(reinterpret_cast<const char*>(&n_blocks), sizeof(n_blocks));
+    if (n_blocks)
+    {
+        file.write(reinterpret_cast<const char*>(C.starts.data()), (n_blocks + 1)*sizeof(std::int64_t));
+        file.write(reinterpret_cast<const char*>(C.offsets.data()), (n_blocks + 1)*sizeof(std::uint64_t));
+        file.write(reinterpret_cast<const char*>(C.data.data()), C.data.size());
+    }
+    file.close();
+}
+
+/**
+ * @brief 
+ * Read the header and block index of a compressed file
+ * 
+ * @param file the opened file
+ * @param C the block index is read into C
+ * @return bool true if the file is a compressed matrix
+ */
+static bool read_index(std::ifstream& file, CompressedTrajectory& C)
+{
+    char magic[8];
+    std::uint64_t n_blocks = 0;
+    file.read(magic, sizeof(magic));
+    file.read(reinterpret_cast<char*>(&n_blocks), sizeof(n_blocks));
+    if (!file || std::memcmp(magic, COMPRESSED_MAGIC, sizeof(magic)))
+        return false;
+    if (!n_blocks)
+        return true;
+
+    C.starts.resize(n_blocks + 1);
+    C.offsets.resize(n_blocks + 1);
+    file.read(reinterpret_cast<char*>(C.starts.data()), (n_blocks + 1)*sizeof(std::int64_t));
+    file.read(reinterpret_cast<char*>(C.offsets.data()), (n_blocks + 1)*sizeof(std::uint64_t));
+
+    return bool(file);
+}
+
+/**
+ * @brief 
+ * Load a compressed matrix saved with save_compressed
+ * 
+ * @param filename file name
+ * @return CompressedTrajectory (empty if the file could not be read)
+ */
+CompressedTrajectory load_compressed(const std::string& filename)
+{
+    CompressedTrajectory C;
+    std::ifstream file(filename, std::ios::binary);
+    if (!read_index(file, C))
+        return CompressedTrajectory();
+
+    if (!C.offsets.empty())
+    {
+        C.data.resize(C.offsets.back());
+        file.read(reinterpret_cast<char*>(C.data.data()), C.data.size());
+    }
+
+    return file ? C : CompressedTrajectory();
+}
+
+/**
+ * @brief 
+ * Load and decompress a single block of a compressed file,
+ * without reading the rest of the file
+ * 
+ * @param filename file name
+ * @param block index of the block
+ * @param Y filled with the columns of the block, must have at least as many columns as the block
+ * @return int number of columns in the block (-1 if it could not be read)
+ */
+int load_compressed_block(const std::string& filename, const int& block, Ref<Matrix<double, 4, Dynamic>> Y)
+{
+    CompressedTrajectory C;
+    std::ifstream file(filename, std::ios::binary);
+    if (!read_index(file, C) || block < 0 || block >= compressed_blocks(C))
+        return -1;
+
+    //The blocks start right after the index
+    std::streamoff data_start = file.tellg();
+    std::vector<unsigned char> data(C.offsets[block+1] - C.offsets[block]);
+    file.seekg(data_start + std::streamoff(C.offsets[block]));
+    file.read(reinterpret_cast<char*>(data.data()), data.size());
+    if (!file)
+        return -1;
+
+    int cols = int(C.starts[block+1] - C.starts[block]);
+    decompress_data(data.data(), cols, Y);
+
+    return cols;
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "utils.h"
+
+// Lossless compressed storage of computed matrices
+// The columns are stored in blocks, and each row of a block is compressed separately:
+// every value is predicted by polynomial extrapolation of the previous values in the row,
+// and only the low (significant) bytes of the difference to the prediction are stored.
+// Blocks are compressed and decompressed independently, so they can be decoded one at a time
+
+//Number of columns in a block
+constexpr int COMPRESSED_BLOCK = 4096;
+
+struct CompressedTrajectory
+{
+    std::vector<unsigned char> data;        //All compressed blocks, one after the other
+    std::vector<std::uint64_t> offsets;     //Start of each block in data, and the end of the last block
+    std::vector<std::int64_t> starts;       //Index of the first column of each block, and the total number of columns
+};
+
+void compress_block(CompressedTrajectory& C, const Ref<const Matrix<double, 4, Dynamic>> Y);
+CompressedTrajectory compress(const Ref<const Matrix<double, 4, Dynamic>> Y);
+int decompress_block(const CompressedTrajectory& C, const int& block, Ref<Matrix<double, 4, Dynamic>> Y);
+Matrix<double, 4, Dynamic> decompress(const CompressedTrajectory& C);
+int compressed_blocks(const CompressedTrajectory& C);
+std::int64_t compressed_cols(const CompressedTrajectory& C);
+void save_compressed(const std::string& filename, const CompressedTrajectory& C);
+CompressedTrajectory load_compressed(const std::string& filename);
+int load_compressed_block(const std::string& filename, const int& block, Ref<Matrix<double, 4, Dynamic>> Y);
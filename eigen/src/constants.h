@@ -5,4 +5,33 @@ constexpr double h      = 0.1;          //Length of timestep
 
 constexpr double H_0    = 1.0/12.0;     //Initial energy of system
 constexpr double t_0    = 0;            //Start time
-constexpr double t_end  = 3e6;          //End time 
\ No newline at end of file
+constexpr double t_end  = 3e6;          //End time 
+
+//Parameters of the sweep distributed over MPI ranks (see main_mpi.cpp)
+//Every combination of step size, energy and initial q2 is one job
+constexpr double sweep_h[]      = {0.1, 0.05, 0.01};                //Timesteps
+constexpr double sweep_H_0[]    = {1.0/12.0, 1.0/10.0, 1.0/8.0};    //Initial energies
+constexpr double sweep_q2[]     = {-0.2, 0.0, 0.2, 0.4};            //Initial q2 of the ensemble members
+constexpr double sweep_t_end    = 1e4;                              //End time of each job
+
+//Parameters of the work-precision benchmark (see problems/benchmark.h, run with ./hhp benchmark)
+constexpr double bench_h[]      = {0.2, 0.1, 0.05, 0.02, 0.01, 0.005, 0.002, 0.001};  //Timesteps
+constexpr double bench_tolerance = 1e-16;   //Tolerance of the reference run (Taylor series method)
+constexpr double bench_t_end    = 1000;     //End time of each run
+constexpr int bench_repeats     = 3;        //Runs of each method and timestep, the fastest is reported
+constexpr int bench_project_every = 1;    //Steps between the projections of the projected rk4 and sb runs
+constexpr double bench_taylor_tolerance[] = {1e-4, 1e-6, 1e-8, 1e-10, 1e-12, 1e-13, 1e-14, 1e-15};   //Tolerances of the Taylor series runs, one for each timestep
+constexpr double bench_dt_out   = 0.1;      //Time between the stored values of the Taylor series and Sundman runs
+
+//Parameters of the escape basins (see problems/escape.h, run with ./hhp escape)
+constexpr double escape_H_0     = 0.2;              //Energy of the orbits, above the threshold 1/6
+constexpr double escape_h       = 0.01;             //Timestep
+constexpr double escape_t_max   = 1000;             //Longest time to integrate an orbit
+constexpr double escape_q2[]    = {-0.8, 1.2};      //Range of q2 of the grid
+constexpr double escape_p2[]    = {-0.8, 0.8};      //Range of p2 of the grid
+constexpr int escape_n_q2       = 400;              //Grid points in q2
+constexpr int escape_n_p2       = 320;              //Grid points in p2
+
+//Parameters of the orbits of an ensemble read from a file (see problems/ensemble.h, run with ./hhp ensemble)
+constexpr double ensemble_h     = 0.01;     //Timestep of the rows without their own
+constexpr double ensemble_t_end = 1000;     //End time of the rows without their own
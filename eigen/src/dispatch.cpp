@@ -0,0 +1,92 @@
+#include "dispatch.h"
+
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+
+/**
+ * @brief 
+ * The best instruction set supported by this CPU
+ * 
+ * @return Isa 
+ */
+static Isa supported_isa()
+{
+#if defined(__GNUC__) && defined(__x86_64__)
+    __builtin_cpu_init();
+    if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512vl") && __builtin_cpu_supports("avx512dq"))
+        return Isa::avx512;
+    if (__builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma"))
+        return Isa::avx2;
+#endif
+    return Isa::baseline;
+}
+
+/**
+ * @brief 
+ * Choose the instruction set of the kernels, the best one supported
+ * unless HHP_ISA asks for another (supported) one, and report it to stderr
+ * 
+ * @return Isa 
+ */
+static Isa choose_isa()
+{
+    Isa supported = supported_isa();
+    Isa isa = supported;
+
+    const char* requested = std::getenv("HHP_ISA");
+    if (requested && *requested)
+    {
+        if (!std::strcmp(requested, "baseline"))
+            isa = Isa::baseline;
+        else if (!std::strcmp(requested, "avx2"))
+            isa = Isa::avx2;
+        else if (!std::strcmp(requested, "avx512"))
+            isa = Isa::avx512;
+        else
+            std::clog << "hhp: unknown HHP_ISA=" << requested << " (baseline, avx2 or avx512), ignored" << std::endl;
+
+        if (isa > supported)
+        {
+            std::clog << "hhp: HHP_ISA=" << requested << " is not supported by this CPU" << std::endl;
+            isa = supported;
+        }
+    }
+
+    //The choice is reported on every start, unless HHP_QUIET is set
+    const char* quiet = std::getenv("HHP_QUIET");
+    if (!quiet || !*quiet)
+        std::clog << "hhp: using " << isa_name(isa) << " kernels" << std::endl;
+
+    return isa;
+}
+
+/**
+ * @brief 
+ * The instruction set used by the kernels, chosen the first time it is needed
+ * 
+ * @return Isa 
+ */
+Isa active_isa()
+{
+    static const Isa isa = choose_isa();
+
+    return isa;
+}
+
+/**
+ * @brief 
+ * Name of an instruction set, as used by HHP_ISA
+ * 
+ * @param isa 
+ * @return const char* 
+ */
+const char* isa_name(const Isa& isa)
+{
+    switch (isa)
+    {
+        case Isa::avx512: return "avx512";
+        case Isa::avx2:   return "avx2";
+        default:          return "baseline";
+    }
+}
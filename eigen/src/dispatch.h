@@ -0,0 +1,44 @@
+#pragma once
+
+// Runtime selection of the instruction set used by the computing kernels
+// The build targets baseline x86-64, so the integrators, hamiltonian() and poincare() are
+// compiled a second and third time for AVX2/FMA and AVX-512, and the best version supported
+// by the CPU is picked once at startup. Setting the environment variable HHP_ISA to
+// baseline, avx2 or avx512 overrides the choice (e.g. for benchmarking)
+
+enum class Isa
+{
+    baseline,
+    avx2,
+    avx512
+};
+
+Isa active_isa();
+const char* isa_name(const Isa& isa);
+
+#if defined(__GNUC__) && defined(__x86_64__)
+
+// Defines the function "name" returning the type given last (with parameters params, and arguments
+// args to forward them) that calls impl compiled for the active instruction set. flatten inlines everything impl calls
+// (including Eigen) into each version, so nothing compiled for AVX is ever shared with baseline code.
+// -O1 never forms FMA instructions, so the AVX versions turn on the (-O2) pass that does
+#define HHP_MULTIVERSION(name, impl, params, args, ...)                                                        \
+    __attribute__((flatten)) static __VA_ARGS__ name##_baseline params { return impl args; }                           \
+    __attribute__((target("avx2,fma"), optimize("expensive-optimizations"), flatten)) static __VA_ARGS__ name##_avx2 params { return impl args; }          \
+    __attribute__((target("avx512f,avx512vl,avx512dq,avx2,fma"), optimize("expensive-optimizations"), flatten)) static __VA_ARGS__ name##_avx512 params { return impl args; } \
+    __VA_ARGS__ name params                                                                                            \
+    {                                                                                                          \
+        switch (active_isa())                                                                                  \
+        {                                                                                                      \
+            case Isa::avx512: return name##_avx512 args;                                                       \
+            case Isa::avx2:   return name##_avx2 args;                                                         \
+            default:          return name##_baseline args;                                                     \
+        }                                                                                                      \
+    }
+
+#else
+
+#define HHP_MULTIVERSION(name, impl, params, args, ...) \
+    __VA_ARGS__ name params { return impl args; }
+
+#endif
@@ -0,0 +1,214 @@
+#include "sweep.h"
+#include "../constants.h"
+
+#include <iostream>
+#include <iterator>
+
+/**
+ * @brief 
+ * Number of jobs in the sweep, one for each combination
+ * of step size, energy and initial q2
+ * 
+ * @return int number of jobs
+ */
+int sweep_size()
+{
+    return int(std::size(sweep_h) * std::size(sweep_H_0) * std::size(sweep_q2));
+}
+
+/**
+ * @brief 
+ * Find the parameters of a job in the sweep
+ * 
+ * @param job index of the job
+ * @param h length of timestep of the job
+ * @param H_0 initial energy of the job
+ * @param q2 initial q2 of the job
+ * @return the initial condition of the job
+ */
+Array<double, 4, 1> sweep_job(const int& job, double& h, double& H_0, double& q2)
+{
+    int n_q2 = int(std::size(sweep_q2));
+    int n_H_0 = int(std::size(sweep_H_0));
+
+    q2 = sweep_q2[job % n_q2];
+    H_0 = sweep_H_0[(job / n_q2) % n_H_0];
+    h = sweep_h[job / (n_q2 * n_H_0)];
+
+    return create_init_cond(H_0, q2);
+}
+
+/**
+ * @brief 
+ * Compute the energy statistics and Poincaré map of one method
+ * 
+ * @param Y the computed matrix of the method
+ * @param method index of the method (rk4, sb, kahans, sv)
+ * @param stats statistics of the job to fill in
+ * @param P the Poincaré map of the method
+ */
+static void job_statistics(const Ref<const Matrix<double, 4, Dynamic>> Y, const int& method, Ref<Matrix<double, SWEEP_STATS, 1>> stats, Matrix<double, 2, Dynamic>& P)
+{
+    Array<double, Dynamic, 1> H = hamiltonian(Y);
+    Array<double, Dynamic, 1> drift = (H - H[0]).abs();
+
+    P = poincare(Y);
+
+    stats[3 + method] = drift.maxCoeff();
+    stats[7 + method] = drift.mean();
+    stats[11 + method] = P.cols();
+}
+
+/**
+ * @brief 
+ * Compute one job of the sweep with all the implemented methods in parallel
+ * 
+ * @param job index of the job
+ * @param t_0 start time
+ * @param t_end end time
+ * @param stats statistics of the job (see SWEEP_STATS)
+ * @param points section points of the job are appended here as (job, method, q2, p2)
+ */
+void compute_job(const int& job, const double& t_0, const double& t_end, Ref<Matrix<double, SWEEP_STATS, 1>> stats, std::vector<double>& points)
+{
+    double h, H_0, q2;
+    Array<double, 4, 1> y0 = sweep_job(job, h, H_0, q2);
+    stats.head<3>() << h, H_0, q2;
+
+    Matrix<double, 2, Dynamic> P[4];
+
+    #pragma omp parallel
+    {
+        #pragma omp single nowait
+        {
+            // Kutta's method
+            #pragma omp task
+            job_statistics(kuttas_method(t_0, t_end, y0, h), 0, stats, P[0]);
+
+            // Shampine-Bogacki
+            #pragma omp task
+            job_statistics(shampine_bogacki(t_0, t_end, y0, h), 1, stats, P[1]);
+
+            // Kahans method
+            #pragma omp task
+            job_statistics(kahans(t_0, t_end, y0, h), 2, stats, P[2]);
+
+            // Störmer-Verlet
+            #pragma omp task
+            job_statistics(stormer_verlet(t_0, t_end, y0, h), 3, stats, P[3]);
+        }
+    }
+
+    for (int method = 0; method < 4; method++)
+    {
+        for (std::int64_t i = 0; i < P[method].cols(); i++)
+        {
+            points.push_back(job);
+            points.push_back(method);
+            points.push_back(P[method].col(i)[0]);
+            points.push_back(P[method].col(i)[1]);
+        }
+    }
+}
+
+/**
+ * @brief 
+ * Compute the whole sweep distributed over all MPI ranks.
+ * Jobs are handed out dynamically by rank 0, so ranks that finish early
+ * simply get more jobs (with more than one rank, rank 0 does not compute any jobs itself).
+ * The statistics and section points are collected on rank 0
+ * 
+ * @param t_0 start time
+ * @param t_end end time
+ */
+void compute_sweep(const double& t_0, const double& t_end)
+{
+    int rank, n_ranks;
+    MPI_Comm_rank(MPI_COMM_WORLD, &rank);
+    MPI_Comm_size(MPI_COMM_WORLD, &n_ranks);
+
+    int n_jobs = sweep_size();
+
+    //Each column holds the statistics of one job, and stays zero on ranks that did not compute it
+    Matrix<double, SWEEP_STATS, Dynamic> stats = Matrix<double, SWEEP_STATS, Dynamic>::Zero(SWEEP_STATS, n_jobs);
+    std::vector<double> points;
+    int jobs_done = 0;
+
+    if (n_ranks == 1)
+    {
+        //Nobody to share the work with
+        for (int job = 0; job < n_jobs; job++)
+        {
+            compute_job(job, t_0, t_end, stats.col(job), points);
+            jobs_done++;
+        }
+    } 
+    else if (rank == 0)
+    {
+        //Rank 0 only hands out jobs, to whichever rank asks first,
+        //and tells every rank to stop once all jobs are handed out
+        int request, stopped = 0;
+        MPI_Status status;
+        for (int job = 0; stopped < n_ranks - 1; job++)
+        {
+            MPI_Recv(&request, 1, MPI_INT, MPI_ANY_SOURCE, SWEEP_REQUEST_TAG, MPI_COMM_WORLD, &status);
+            int reply = (job < n_jobs) ? job : -1;
+            MPI_Send(&reply, 1, MPI_INT, status.MPI_SOURCE, SWEEP_JOB_TAG, MPI_COMM_WORLD);
+            if (reply < 0)
+                stopped++;
+        }
+    } 
+    else
+    {
+        //Ask for a new job every time the previous one is done
+        int job = 0;
+        while (true)
+        {
+            MPI_Send(&rank, 1, MPI_INT, 0, SWEEP_REQUEST_TAG, MPI_COMM_WORLD);
+            MPI_Recv(&job, 1, MPI_INT, 0, SWEEP_JOB_TAG, MPI_COMM_WORLD, MPI_STATUS_IGNORE);
+
+            if (job < 0)
+                break;
+
+            compute_job(job, t_0, t_end, stats.col(job), points);
+            jobs_done++;
+        }
+    }
+
+    //Every job was computed by exactly one rank, so summing gives the statistics of all jobs
+    Matrix<double, SWEEP_STATS, Dynamic> all_stats = Matrix<double, SWEEP_STATS, Dynamic>::Zero(SWEEP_STATS, n_jobs);
+    MPI_Reduce(stats.data(), all_stats.data(), int(stats.size()), MPI_DOUBLE, MPI_SUM, 0, MPI_COMM_WORLD);
+
+    //Largest energy drift of each method over the whole sweep
+    Matrix<double, 4, 1> max_drift = stats.middleRows<4>(3).rowwise().maxCoeff();
+    Matrix<double, 4, 1> all_max_drift;
+    MPI_Reduce(max_drift.data(), all_max_drift.data(), 4, MPI_DOUBLE, MPI_MAX, 0, MPI_COMM_WORLD);
+
+    //Collect the section points of all ranks on rank 0
+    int n_values = int(points.size());
+    std::vector<int> counts(n_ranks), displacements(n_ranks, 0), all_jobs_done(n_ranks);
+    MPI_Gather(&n_values, 1, MPI_INT, counts.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    MPI_Gather(&jobs_done, 1, MPI_INT, all_jobs_done.data(), 1, MPI_INT, 0, MPI_COMM_WORLD);
+    for (int r = 1; r < n_ranks; r++)
+        displacements[r] = displacements[r-1] + counts[r-1];
+
+    std::vector<double> all_points((rank == 0) ? displacements[n_ranks-1] + counts[n_ranks-1] : 0);
+    MPI_Gatherv(points.data(), n_values, MPI_DOUBLE, all_points.data(), counts.data(), displacements.data(), MPI_DOUBLE, 0, MPI_COMM_WORLD);
+
+    if (rank != 0)
+        return;
+
+    //Section points as columns of (job, method, q2, p2)
+    Eigen::Map<Matrix<double, 4, Dynamic>> P(all_points.data(), 4, all_points.size()/4);
+
+    std::cout << "Sweep of " << n_jobs << " jobs on " << n_ranks << " ranks, jobs per rank:";
+    for (int r = 0; r < n_ranks; r++)
+        std::cout << " " << all_jobs_done[r];
+    std::cout << "\nSection points: " << P.cols() << "\n";
+    std::cout << "Max energy drift (rk4, sb, kahans, sv): " << all_max_drift.transpose() << std::endl;
+
+    //Uncomment the line(s) below if you actaully want the output
+    // matrix_to_CSV(sweep_stats_file + ".csv", all_stats.transpose());
+
+    // matrix_to_CSV(sweep_poincare_file + ".csv", P.transpose());
+}
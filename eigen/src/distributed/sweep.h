@@ -0,0 +1,21 @@
+#pragma once
+
+#include <mpi.h>
+#include <vector>
+
+#include "../problems/compute.h"
+
+//Sweeps over step sizes, energies and initial conditions distributed over MPI ranks
+//Each rank runs its jobs with OpenMP, like compute_both
+
+//Number of statistics stored for each job (h, H_0, q2, then max drift, mean drift and crossings per method)
+constexpr int SWEEP_STATS = 3 + 3*4;
+
+//Tags of the messages used to hand out jobs
+constexpr int SWEEP_REQUEST_TAG = 1;
+constexpr int SWEEP_JOB_TAG = 2;
+
+int sweep_size();
+Array<double, 4, 1> sweep_job(const int& job, double& h, double& H_0, double& q2);
+void compute_job(const int& job, const double& t_0, const double& t_end, Ref<Matrix<double, SWEEP_STATS, 1>> stats, std::vector<double>& points);
+void compute_sweep(const double& t_0, const double& t_end);
@@ -0,0 +1,154 @@
+#include "memory.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdlib>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief
+ * Size of the mapping of a large buffer, a whole number of huge pages
+ */
+static std::size_t mapped_bytes(const std::size_t& bytes)
+{
+    return (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+}
+
+/**
+ * @brief
+ * Map anonymous memory aligned to a huge page. More than asked for is mapped,
+ * and the unaligned head and the tail are unmapped again
+ *
+ * @param bytes size of the mapping, a whole number of huge pages
+ * @return void* the mapping, or nullptr if it failed
+ */
+static void* map_aligned(const std::size_t& bytes)
+{
+    void* p = mmap(nullptr, bytes + HUGE_PAGE_BYTES, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (p == MAP_FAILED)
+        return nullptr;
+
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(p);
+    std::uintptr_t aligned = (start + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    if (aligned > start)
+        munmap(p, aligned - start);
+    munmap(reinterpret_cast<void*>(aligned + bytes), start + HUGE_PAGE_BYTES - aligned);
+
+    return reinterpret_cast<void*>(aligned);
+}
+
+/**
+ * @brief
+ * Allocate a buffer aligned to STORAGE_ALIGN bytes. The memory is not initialized,
+ * and buffers of at least HUGE_PAGE_BYTES are not touched either (see memory.h)
+ *
+ * @param bytes size of the buffer
+ * @return void* the buffer, free it with free_storage and the same size
+ */
+void* allocate_storage(const std::size_t& bytes)
+{
+    //Small buffers are not worth a mapping of their own
+    if (bytes < HUGE_PAGE_BYTES)
+    {
+        //aligned_alloc requires the size to be a multiple of the alignment
+        void* p = std::aligned_alloc(STORAGE_ALIGN, (bytes + STORAGE_ALIGN - 1) / STORAGE_ALIGN * STORAGE_ALIGN);
+        if (!p && bytes)
+            throw std::bad_alloc();
+        return p;
+    }
+
+    std::size_t size = mapped_bytes(bytes);
+
+    //Explicit huge pages come from the pool reserved in /proc/sys/vm/nr_hugepages,
+    //fall back to transparent huge pages if it is (too) empty. The pages are reserved
+    //(no MAP_NORESERVE), so an empty pool fails here instead of with a SIGBUS on first touch
+    if (HUGE_PAGES == 2)
+    {
+        void* p = mmap(nullptr, size, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+        if (p != MAP_FAILED)
+            return p;
+    }
+
+    void* p = map_aligned(size);
+    if (!p)
+        throw std::bad_alloc();
+    advise_storage(p, size);
+
+    return p;
+}
+
+/**
+ * @brief
+ * Free a buffer allocated with allocate_storage
+ *
+ * @param p the buffer
+ * @param bytes size it was allocated with
+ */
+void free_storage(void* p, const std::size_t& bytes)
+{
+    if (bytes < HUGE_PAGE_BYTES)
+        std::free(p);
+    else if (p)
+        munmap(p, mapped_bytes(bytes));
+}
+
+/**
+ * @brief
+ * Ask for transparent huge pages for the whole huge pages inside a buffer,
+ * also for buffers allocated elsewhere (like the data of an Eigen matrix).
+ * Only has an effect on pages that are not touched yet
+ *
+ * @param p start of the buffer
+ * @param bytes size of the buffer
+ */
+void advise_storage(void* p, const std::size_t& bytes)
+{
+    if (HUGE_PAGES == 0)
+        return;
+
+    std::uintptr_t start = reinterpret_cast<std::uintptr_t>(p);
+    std::uintptr_t begin = (start + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+    std::uintptr_t end = (start + bytes) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+
+    //A failure (e.g. a kernel without transparent huge pages) only means normal pages are used
+    if (end > begin)
+        madvise(reinterpret_cast<void*>(begin), end - begin, MADV_HUGEPAGE);
+}
+
+/**
+ * @brief
+ * Touch the pages of an untouched buffer of columns in parallel, one block of PARALLEL_BLOCK columns
+ * at a time with a static schedule, so each page is placed on the NUMA node of the thread that
+ * handles its block in a parallel pass with the same blocks and schedule (like hamiltonian()).
+ * One value is written on every page, the rest is left as it is
+ *
+ * @param p start of the buffer
+ * @param cols number of columns
+ * @param col_bytes size of a column, in bytes
+ */
+void first_touch(void* p, const std::int64_t& cols, const std::size_t& col_bytes)
+{
+    if (!PARALLEL_FIRST_TOUCH || cols <= 0)
+        return;
+
+    //With huge pages every huge page is placed by the first of its small pages that is touched
+    std::int64_t page = sysconf(_SC_PAGESIZE);
+    std::int64_t start = reinterpret_cast<std::intptr_t>(p);
+    std::int64_t end = start + cols*std::int64_t(col_bytes);
+    std::int64_t block_bytes = PARALLEL_BLOCK*std::int64_t(col_bytes);
+    std::int64_t n_blocks = (cols + PARALLEL_BLOCK - 1) / PARALLEL_BLOCK;
+
+    #pragma omp parallel for schedule(static)
+    for (std::int64_t b = 0; b < n_blocks; b++)
+    {
+        std::int64_t begin = start + b*block_bytes;
+        std::int64_t last = std::min(end, begin + block_bytes) - 1;
+        for (std::int64_t k = begin / page; k <= last / page; k++)
+        {
+            char* c = reinterpret_cast<char*>(std::max(k*page, begin));
+            *c = 0;
+        }
+    }
+}
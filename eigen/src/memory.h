@@ -0,0 +1,28 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "storage_info.h"
+
+// Allocation of the large buffers the runs store their output in
+// Large buffers are mapped directly from the kernel, aligned to a huge page and (depending on
+// HUGE_PAGES in storage_info) backed by transparent or explicit huge pages, so a multi-GB run
+// takes a few thousand page faults instead of a million. The kernel hands out zeroed pages, so
+// the buffers are never zeroed again: every page is placed on the NUMA node of the thread that
+// first writes it (first touch), which is the thread that fills it unless first_touch is used
+
+//Alignment of every buffer, in bytes (one cache line, and one AVX-512 register)
+constexpr std::size_t STORAGE_ALIGN = 64;
+
+//Size of a huge page, buffers at least this large are mapped directly
+constexpr std::size_t HUGE_PAGE_BYTES = std::size_t(2) << 20;
+
+//Number of columns in each block of the parallel passes over stored output (e.g. hamiltonian()),
+//first_touch places the pages of a buffer with the same blocks
+constexpr std::int64_t PARALLEL_BLOCK = 4096;
+
+void* allocate_storage(const std::size_t& bytes);
+void free_storage(void* p, const std::size_t& bytes);
+void advise_storage(void* p, const std::size_t& bytes);
+void first_touch(void* p, const std::int64_t& cols, const std::size_t& col_bytes);
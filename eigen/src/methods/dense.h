@@ -0,0 +1,92 @@
+#pragma once
+
+//Dense output (cubic Hermite interpolation) for the fixed-step methods,
+//to output the system on any grid of times independent of the timestep
+
+#include "../utils.h"
+
+/**
+ * @brief 
+ * Cubic Hermite interpolation between two steps, 
+ * using the values and derivatives at both ends
+ * 
+ * @param y_prev values at the start of the step
+ * @param f_prev derivatives at the start of the step
+ * @param y_next values at the end of the step
+ * @param f_next derivatives at the end of the step
+ * @param h length of the step
+ * @param theta fraction of the step to interpolate at (0 to 1)
+ * @param y_out the interpolated values
+ */
+inline void hermite_interpolate(const Ref<const Array<double, 4, 1>> y_prev, const Ref<const Array<double, 4, 1>> f_prev, const Ref<const Array<double, 4, 1>> y_next, const Ref<const Array<double, 4, 1>> f_next, const double& h, const double& theta, Ref<Array<double, 4, 1>> y_out)
+{
+    double theta2 = theta*theta;
+    double theta3 = theta2*theta;
+
+    double h00 = 2*theta3 - 3*theta2 + 1;
+    double h10 = theta3 - 2*theta2 + theta;
+    double h01 = -2*theta3 + 3*theta2;
+    double h11 = theta3 - theta2;
+
+    y_out = h00*y_prev + h10*h*f_prev + h01*y_next + h11*h*f_next;
+}
+
+/**
+ * @brief 
+ * Integrate with a fixed step method, but store the system at the times
+ * t_0, t_0 + dt_out, t_0 + 2*dt_out, ... (see create_T_dense) by interpolating between steps
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @param dt_out Time between each stored value
+ * @param f0 Derivative of the system at y0
+ * @param step Performs one step step(y, f, h), where f is the derivative at y before and after the step
+ * @return Y matrix with one column for each output time
+ */
+template <typename Step>
+Matrix<double, 4, Dynamic> dense_output(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& dt_out, const Ref<const Array<double, 4, 1>> f0, Step step)
+{
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    double last_step = std::get<3>(vals);
+
+    //The output is independent of h, and only depends on dt_out (same times as create_T_dense)
+    std::int64_t m = std::int64_t(std::floor((t_end - t_0)/dt_out + 1e-10)) + 1;
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
+    Y.col(0) = y0;
+
+    Array<double, 4, 1> y_curr = y0, f_curr = f0;
+    Array<double, 4, 1> y_prev, f_prev, y_out;
+
+    //Index of the next output, and its time
+    std::int64_t out_index = 1;
+    double t_out = t_0 + dt_out;
+
+    for (std::int64_t i = 1; i < n; i++)
+    {
+        //Times are computed from the step number, so they do not drift
+        double t_prev = t_0 + (i - 1)*h;
+        double step_size = (i < n - 1) ? h : last_step;
+        double t_next = (i < n - 1) ? t_0 + i*h : t_end;
+
+        y_prev = y_curr;
+        f_prev = f_curr;
+        step(y_curr, f_curr, step_size);
+
+        //Every output time that lies in this step
+        while (out_index < m && (t_out <= t_next || i == n - 1))
+        {
+            //An output time on the end of the step gives exactly the computed step
+            double theta = (t_out >= t_next) ? 1.0 : (t_out - t_prev)/step_size;
+            hermite_interpolate(y_prev, f_prev, y_curr, f_curr, step_size, theta, y_out);
+            Y.col(out_index) = y_out;
+
+            out_index++;
+            t_out = t_0 + out_index*dt_out;
+        }
+    }
+
+    return Y;
+}
@@ -0,0 +1,315 @@
+#include "gauss.h"
+#include "../potentials.h"
+
+#include <cfloat>
+#include <limits>
+#include <stdexcept>
+
+//Maximum number of (simplified) Newton iterations each step
+constexpr int GAUSS_MAX_ITERATIONS = 20;
+
+//Once rounding errors stop the iterations from improving, the step is still accepted if the
+//last correction was within this multiple of the tolerance
+constexpr double GAUSS_STALL_FACTOR = 16;
+
+//The Newton matrix is kept from step to step, and factored again after a step that took more
+//iterations than this (or did not converge with the old one)
+constexpr int GAUSS_REFACTOR_ITERATIONS = 6;
+
+/**
+ * @brief 
+ * Butcher tableau of the s-stage Gauss-Legendre method,
+ * and the helpers derived from it
+ */
+template <int s>
+struct GaussTableau
+{
+    Matrix<double, s, s> A;
+    Matrix<double, s, 1> b;
+    Matrix<double, s, 1> c;
+    Matrix<double, s, 1> d;     //y_next = y_curr + Z*d, with d = A^-T b (no extra evaluations of the system)
+    Matrix<double, s, s> E;     //Extrapolates the stages of a step to the guess for the next step
+};
+
+/**
+ * @brief 
+ * The jacobian of the Hénon Heiles system
+ * 
+ * @param y The values to evaluate the jacobian at
+ * @param J The jacobian
+ */
+void henon_heiles_jacobian(const Ref<const Array<double, 4, 1>> y, Ref<Matrix<double, 4, 4>> J)
+{
+    J.setZero();
+    J(0, 2) = -(1 + 2*y[3]);
+    J(0, 3) = -2*y[2];
+    J(1, 2) = -2*y[2];
+    J(1, 3) = -(1 - 2*y[3]);
+    J(2, 0) = 1;
+    J(3, 1) = 1;
+}
+
+/**
+ * @brief 
+ * Create the Butcher tableau of the s-stage Gauss-Legendre method
+ * 
+ * @return GaussTableau<s> 
+ */
+template <int s>
+static GaussTableau<s> gauss_tableau()
+{
+    GaussTableau<s> tab;
+
+    if constexpr (s == 1)
+    {
+        tab.A << 0.5;
+        tab.b << 1;
+        tab.c << 0.5;
+    }
+    else if constexpr (s == 2)
+    {
+        double r3 = std::sqrt(3.0);
+        tab.A << 0.25,           0.25 - r3/6,
+                 0.25 + r3/6,    0.25;
+        tab.b << 0.5, 0.5;
+        tab.c << 0.5 - r3/6, 0.5 + r3/6;
+    }
+    else
+    {
+        static_assert(s == 3, "Only the Gauss-Legendre methods with 1, 2 and 3 stages are implemented");
+        double r15 = std::sqrt(15.0);
+        tab.A << 5.0/36,            2.0/9 - r15/15,     5.0/36 - r15/30,
+                 5.0/36 + r15/24,   2.0/9,              5.0/36 - r15/24,
+                 5.0/36 + r15/30,   2.0/9 + r15/15,     5.0/36;
+        tab.b << 5.0/18, 4.0/9, 5.0/18;
+        tab.c << 0.5 - r15/10, 0.5, 0.5 + r15/10;
+    }
+
+    tab.d = tab.A.transpose().partialPivLu().solve(tab.b);
+
+    //The stages of a step lie on the collocation polynomial w through (0, 0) and (c_j, Z_j),
+    //so the stages of the next step are guessed as w(1 + c_i) - w(1)
+    auto lagrange = [&](int j, double theta)
+    {
+        double l = theta / tab.c[j];
+        for (int k = 0; k < s; k++)
+        {
+            if (k != j)
+                l *= (theta - tab.c[k]) / (tab.c[j] - tab.c[k]);
+        }
+        return l;
+    };
+    for (int i = 0; i < s; i++)
+    {
+        for (int j = 0; j < s; j++)
+            tab.E(i, j) = lagrange(j, 1 + tab.c[i]) - lagrange(j, 1);
+    }
+
+    return tab;
+}
+
+/**
+ * @brief 
+ * Factor the Newton matrix I - h (A x J) of the stage equations, with the jacobian J at y
+ * 
+ * @param y the values to evaluate the jacobian at
+ * @param tab Butcher tableau of the method
+ * @param h timestep length
+ * @param lu the factorization
+ * @param stats counts the factorization (may be nullptr)
+ */
+template <int s>
+static void gauss_factor(const Ref<const Array<double, 4, 1>> y, const GaussTableau<s>& tab, const double& h, Eigen::PartialPivLU<Matrix<double, 4*s, 4*s>>& lu, GaussStats* stats)
+{
+    if (stats)
+        stats->factorizations++;
+
+    Matrix<double, 4, 4> J;
+    henon_heiles_jacobian(y, J);
+    Matrix<double, 4*s, 4*s> M = Matrix<double, 4*s, 4*s>::Identity();
+    for (int i = 0; i < s; i++)
+    {
+        for (int j = 0; j < s; j++)
+            M.template block<4, 4>(4*i, 4*j) -= h * tab.A(i, j) * J;
+    }
+    lu.compute(M);
+}
+
+/**
+ * @brief 
+ * Solve the stage equations Z_i = h sum_j a_ij f(y + Z_j) of a step with simplified Newton
+ * iterations, starting from the guess in Z
+ * 
+ * @param y_curr the current values of the system
+ * @param Z stage increments, guess in and solution out
+ * @param tab Butcher tableau of the method
+ * @param h timestep length
+ * @param lu factorization of the Newton matrix (see gauss_factor)
+ * @return int the number of iterations, or -1 if they did not converge
+ */
+template <int s>
+static int gauss_newton(const Ref<const Array<double, 4, 1>> y_curr, Matrix<double, 4, s>& Z, const GaussTableau<s>& tab, const double& h, const Eigen::PartialPivLU<Matrix<double, 4*s, 4*s>>& lu)
+{
+    Matrix<double, 4, s> F;
+    Matrix<double, 4, s> G;
+    Matrix<double, 4*s, 1> dZ;
+    double tolerance = DBL_EPSILON * std::max(1.0, y_curr.abs().maxCoeff());
+    double prev_norm = std::numeric_limits<double>::infinity();
+
+    for (int it = 0; it < GAUSS_MAX_ITERATIONS; it++)
+    {
+        for (int j = 0; j < s; j++)
+            potential_rhs(HenonHeiles(), y_curr + Z.col(j).array(), F.col(j).array());
+
+        //Residual of the stage equations
+        G = -Z + h * F * tab.A.transpose();
+        dZ = lu.solve(Eigen::Map<Matrix<double, 4*s, 1>>(G.data()));
+        Z += Eigen::Map<Matrix<double, 4, s>>(dZ.data());
+
+        //Stop when converged, or when rounding errors stop the iterations from improving,
+        //which only counts as converged close to the tolerance
+        double norm = dZ.cwiseAbs().maxCoeff();
+        if (norm <= tolerance || norm >= prev_norm)
+            return (std::min(norm, prev_norm) <= GAUSS_STALL_FACTOR * tolerance) ? it + 1 : -1;
+        prev_norm = norm;
+    }
+
+    return -1;
+}
+
+/**
+ * @brief 
+ * Perform one step of the s-stage Gauss-Legendre method.
+ * The stage equations are solved with simplified Newton iterations, with the Newton matrix
+ * factored in lu (see gauss_factor). The factorization is kept from step to step, and only
+ * refreshed at y_curr when the iterations fail or become slow, as the orbit moved away from
+ * where the jacobian was evaluated. The guess in Z is replaced by the guess for the next step
+ * 
+ * @param y_curr the current values of the system
+ * @param Z stage increments, guess in and guess for the next step out
+ * @param tab Butcher tableau of the method
+ * @param h timestep length
+ * @param lu factorization of the Newton matrix for this h, refreshed when needed
+ * @param stats counts the step, its iterations and factorizations (may be nullptr)
+ */
+template <int s>
+static void gauss_iteration(Ref<Array<double, 4, 1>> y_curr, Matrix<double, 4, s>& Z, const GaussTableau<s>& tab, const double& h, Eigen::PartialPivLU<Matrix<double, 4*s, 4*s>>& lu, GaussStats* stats)
+{
+    Matrix<double, 4, s> guess = Z;
+    int iterations = gauss_newton<s>(y_curr, Z, tab, h, lu);
+    if (iterations < 0)
+    {
+        //The failed iterations count too
+        if (stats)
+            stats->iterations += GAUSS_MAX_ITERATIONS;
+
+        gauss_factor<s>(y_curr, tab, h, lu, stats);
+        Z = guess;
+        iterations = gauss_newton<s>(y_curr, Z, tab, h, lu);
+    }
+
+    //An unconverged step is not symplectic, and would silently spoil the rest of the run
+    if (iterations < 0)
+        throw std::runtime_error("gauss_iteration: the stage equations did not converge, try a smaller timestep");
+
+    y_curr += (Z * tab.d).array();
+    if (stats)
+    {
+        stats->steps++;
+        stats->iterations += iterations;
+    }
+
+    if (iterations > GAUSS_REFACTOR_ITERATIONS)
+        gauss_factor<s>(y_curr, tab, h, lu, stats);
+
+    Z = Z * tab.E.transpose();
+}
+
+/**
+ * @brief 
+ * The s-stage Gauss-Legendre method (order 2s, symplectic)
+ * implemented for the Hénon Heiles system
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @param stats filled with the number of steps, Newton iterations and factorizations (may be nullptr)
+ * @return Y matrix
+ */
+template <int s>
+static Matrix<double, 4, Dynamic> gauss_legendre_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, GaussStats* stats)
+{
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    std::int64_t m = std::get<1>(vals);
+    int skip_storage = std::get<2>(vals);
+    double last_step = std::get<3>(vals);
+
+    static const GaussTableau<s> tab = gauss_tableau<s>();
+
+    //Init a matrix to be of the same dimension as the init-cond
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
+    Y.col(0) = y0;
+
+    //Since we're not necessarily storing every iteration in the matrix,
+    //we need an array to store the current iteration in time
+    Array<double, 4, 1> y_curr = y0;
+
+    //The first guess of the stages is an Euler step to each stage
+    Array<double, 4, 1> f0;
+    potential_rhs(HenonHeiles(), y0, f0);
+    Matrix<double, 4, s> Z = h * f0.matrix() * tab.c.transpose();
+
+    //The Newton matrix is factored once, and only again when the iterations slow down
+    Eigen::PartialPivLU<Matrix<double, 4*s, 4*s>> lu;
+    gauss_factor<s>(y0, tab, h, lu, stats);
+
+    //Index to keep count of where to store in matrix
+    std::int64_t storage_index = 1;
+
+    //Compute the system forward in time
+    for (std::int64_t i = 1; i < n - 1; i++)
+    {
+        gauss_iteration<s>(y_curr, Z, tab, h, lu, stats);
+        if (!(i % skip_storage))
+        {
+            Y.col(storage_index) = y_curr;
+            storage_index++;
+        }
+    }
+
+    //Use last_step as step size to compute the last step
+    //(with its own Newton matrix, unless it is a whole step)
+    Z *= last_step / h;
+    if (last_step != h)
+        gauss_factor<s>(y_curr, tab, last_step, lu, stats);
+    gauss_iteration<s>(y_curr, Z, tab, last_step, lu, stats);
+    Y.col(m-1) = y_curr;
+
+    return Y;
+}
+
+//The implicit midpoint rule (1 stage, order 2) compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    implicit_midpoint, gauss_legendre_impl<1>,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, GaussStats* stats),
+    (t_0, t_end, y0, h, stats),
+    Matrix<double, 4, Dynamic>
+)
+
+//The 2 stage Gauss-Legendre method (order 4) compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    gauss_legendre_4, gauss_legendre_impl<2>,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, GaussStats* stats),
+    (t_0, t_end, y0, h, stats),
+    Matrix<double, 4, Dynamic>
+)
+
+//The 3 stage Gauss-Legendre method (order 6) compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    gauss_legendre_6, gauss_legendre_impl<3>,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, GaussStats* stats),
+    (t_0, t_end, y0, h, stats),
+    Matrix<double, 4, Dynamic>
+)
@@ -0,0 +1,18 @@
+#pragma once
+
+//Gauss-Legendre methods (implicit symplectic Runge Kutta methods of order 2, 4 and 6)
+
+#include "../utils.h"
+#include <eigen3/Eigen/LU>
+
+struct GaussStats
+{
+    std::int64_t steps = 0;             //Number of steps
+    std::int64_t iterations = 0;        //Newton iterations of all steps (s evaluations of the system each)
+    std::int64_t factorizations = 0;    //LU factorizations of the Newton matrix
+};
+
+void henon_heiles_jacobian(const Ref<const Array<double, 4, 1>> y, Ref<Matrix<double, 4, 4>> J);
+Matrix<double, 4, Dynamic> implicit_midpoint(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, GaussStats* stats = nullptr);
+Matrix<double, 4, Dynamic> gauss_legendre_4(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, GaussStats* stats = nullptr);
+Matrix<double, 4, Dynamic> gauss_legendre_6(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, GaussStats* stats = nullptr);
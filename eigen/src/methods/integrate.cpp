@@ -0,0 +1,134 @@
+#include "integrate.h"
+
+/**
+ * @brief
+ * Create the work arrays of a method chosen by name
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @return MethodStepper
+ */
+MethodStepper create_stepper(const std::string& method, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    MethodStepper S;
+    S.h = h;
+
+    if (method == "rk4")
+        S.method = 0;
+    else if (method == "sb")
+        S.method = 1;
+    else if (method == "kahans")
+        S.method = 2;
+    else if (method == "sv")
+    {
+        S.method = 3;
+        sv_half_force(HenonHeiles(), y0, h, S.q_next);
+    }
+    else
+        throw std::invalid_argument("create_stepper: unknown method " + method);
+
+    return S;
+}
+
+/**
+ * @brief
+ * Perform one step of the method of a stepper, the same step the method itself performs
+ *
+ * @param S the stepper
+ * @param y the values of the system, replaced by the values after the step
+ * @param step_size length of the step, only the last step may differ from S.h
+ */
+static void method_step_impl(MethodStepper& S, Ref<Array<double, 4, 1>> y, const double& step_size)
+{
+    switch (S.method)
+    {
+        case 0:
+            kutta_iteration(HenonHeiles(), y, S.Y_rk, step_size);
+            break;
+        case 1:
+            sb_iteration(HenonHeiles(), y, S.Y_sb, step_size);
+            break;
+        case 2:
+            create_A(HenonHeiles(), y, step_size, S.A);
+            create_b(HenonHeiles(), y, step_size, S.b);
+            y = S.A.partialPivLu().solve(S.b).array();
+            break;
+        default:
+            if (step_size != S.h)
+                sv_half_force(HenonHeiles(), y, step_size, S.q_next);
+            henon_heiles_sv(HenonHeiles(), y, step_size, S.q_next);
+            break;
+    }
+}
+
+//A step compiled for each instruction set (see dispatch.h), so the steps are the same as those of the methods
+HHP_MULTIVERSION(
+    method_step, method_step_impl,
+    (MethodStepper& S, Ref<Array<double, 4, 1>> y, const double& step_size),
+    (S, y, step_size),
+    void
+)
+
+/**
+ * @brief
+ * A run that is not computed yet, positioned at the initial condition
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ */
+Integration::Integration(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+    : stepper(create_stepper(method, y0, h)), t_0(t_0), t_end(t_end), h(h)
+{
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    n = std::get<0>(vals);
+    last_step = std::get<3>(vals);
+
+    sample.t = t_0;
+    sample.y = y0;
+}
+
+/**
+ * @brief
+ * Compute the next step, or end the range after the step to t_end
+ */
+void Integration::advance()
+{
+    if (i >= n - 1)
+    {
+        done = true;
+        return;
+    }
+
+    i++;
+    if (i < n - 1)
+    {
+        method_step(stepper, sample.y, h);
+        //Times are computed from the step number, so they do not drift
+        sample.t = t_0 + i*h;
+    }
+    else
+    {
+        method_step(stepper, sample.y, last_step);
+        sample.t = t_end;
+    }
+}
+
+/**
+ * @brief
+ * Integrate lazily with one of the methods chosen by name (see integrate.h)
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @param t_end end time
+ * @param t_0 start time
+ * @return Integration the range of the values at every step, starting with y0 at t_0
+ */
+Integration integrate(const std::string& method, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& t_end, const double& t_0)
+{
+    return Integration(method, t_0, t_end, y0, h);
+}
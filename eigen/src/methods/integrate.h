@@ -0,0 +1,96 @@
+#pragma once
+
+#include <cstddef>
+#include <iterator>
+
+#include "kahans.h"
+#include "rk4.h"
+#include "sb.h"
+#include "sv.h"
+
+//Lazy integration: integrate(method, y0, h, t_end) is a range of the values of the system at every
+//step, and a step is only computed when the consumer asks for the next one. Nothing is stored,
+//and a consumer that stops early (break, std::views::take_while) stops the integration too
+//
+//  for (auto [t, y] : integrate("sv", y0, h, t_end))
+//
+//The range is a C++20 input range, so it composes with the range adaptors of <ranges>
+//(std::views::filter for decimation or a Poincaré section, std::views::take_while for escapes)
+
+//The values of the system at time t
+struct Sample
+{
+    double t;
+    Array<double, 4, 1> y;
+};
+
+//One step of a method chosen by name, with the work arrays of that method
+struct MethodStepper
+{
+    int method = 0;                                                 //0 rk4, 1 sb, 2 kahans, 3 sv
+    double h = 0;                                                   //Length of the timestep the run uses
+    Matrix<double, 4, 4> Y_rk = Matrix<double, 4, 4>::Zero();       //Stages of Kutta's method
+    Matrix<double, 4, 3> Y_sb = Matrix<double, 4, 3>::Zero();       //Stages of Shampine-Bogacki
+    Matrix<double, 4, 4> A = Matrix<double, 4, 4>::Identity();      //Linear system of Kahan's method
+    Matrix<double, 4, 1> b = Matrix<double, 4, 1>::Zero();
+    Array<double, 2, 1> q_next = Array<double, 2, 1>::Zero();       //Positions after the next step of Störmer-Verlet
+};
+
+MethodStepper create_stepper(const std::string& method, const Ref<const Array<double, 4, 1>> y0, const double& h);
+void method_step(MethodStepper& S, Ref<Array<double, 4, 1>> y, const double& step_size);
+
+class Integration
+{
+public:
+    //End of the range, reached after the step to t_end
+    struct Sentinel {};
+
+    class Iterator
+    {
+    public:
+        using value_type = Sample;
+        using reference = const Sample&;
+        using difference_type = std::ptrdiff_t;
+        using iterator_category = std::input_iterator_tag;
+
+        Iterator() = default;
+        explicit Iterator(Integration* run) : run(run) {}
+
+        const Sample& operator*() const { return run->sample; }
+        const Sample* operator->() const { return &run->sample; }
+
+        //Computes the next step
+        Iterator& operator++()
+        {
+            run->advance();
+            return *this;
+        }
+
+        void operator++(int) { run->advance(); }
+
+        friend bool operator==(const Iterator& it, const Sentinel&) { return it.at_end(); }
+
+    private:
+        bool at_end() const { return run->done; }
+
+        Integration* run = nullptr;
+    };
+
+    Integration(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+
+    //The range can only be iterated once, begin() continues where the last iteration stopped
+    Iterator begin() { return Iterator(this); }
+    Sentinel end() const { return Sentinel(); }
+
+private:
+    void advance();
+
+    MethodStepper stepper;
+    Sample sample;
+    double t_0, t_end, h, last_step;
+    std::int64_t i = 0;     //Index of the current step
+    std::int64_t n;         //Number of values, including the initial condition (see create_H)
+    bool done = false;
+};
+
+Integration integrate(const std::string& method, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& t_end, const double& t_0 = 0);
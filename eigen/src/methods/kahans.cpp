@@ -10,12 +10,7 @@
  */
 void create_A(const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Matrix<double, 4, 4>> A)
 {
-    A.col(2)[0] = h*(y[3] + 0.5);
-    A.col(3)[0] = h*y[2];
-    A.col(2)[1] = h*y[2];
-    A.col(3)[1] = h*(0.5 - y[3]);
-    A.col(0)[2] = -0.5*h;
-    A.col(1)[3] = -0.5*h;
+    create_A(HenonHeiles(), y, h, A);
 }
 
 /**
@@ -28,10 +23,7 @@ void create_A(const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Matri
  */
 void create_b(const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Matrix<double, 4, 1>> b)
 {
-    b[0] = y[0] - 0.5*h*y[2];
-    b[1] = y[1] - 0.5*h*y[3];
-    b[2] = y[2] + 0.5*h*y[0];
-    b[3] = y[3] + 0.5*h*y[1];
+    create_b(HenonHeiles(), y, h, b);
 }
 
 /**
@@ -57,18 +49,19 @@ void kahans_iteration(const Ref<const Array<double, 4, 1>> y_curr, const double&
  * @param t_end end time
  * @param y0 initial condition
  * @param h timestep length
+ * @param checkpoint_file file to checkpoint the run to, and resume it from (empty to disable)
  * @return mat solution for all time
  */
-Matrix<double, 4, Dynamic> kahans(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+static Matrix<double, 4, Dynamic> kahans_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file)
 {
-    std::tuple<int, int, int, double> vals = create_H(t_0, t_end, h);
-    int n = std::get<0>(vals);
-    int m = std::get<1>(vals);
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    std::int64_t m = std::get<1>(vals);
     int skip_storage = std::get<2>(vals);
     double last_step = std::get<3>(vals);
 
     //Init a matrix to be of the same dimension as the init-cond
-    Matrix<double, 4, Dynamic> Y = Matrix<double, 4, Dynamic>::Zero(4, m);
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
     Y.col(0) = y0;
 
     //Matrix and vector used for solving linear system each step
@@ -80,10 +73,23 @@ Matrix<double, 4, Dynamic> kahans(const double& t_0, const double& t_end, const
     Matrix<double, 4, 1> y_curr = y0;
 
     //Index to keep count of where to store in matrix
-    int storage_index = 1;
+    std::int64_t storage_index = 1;
+
+    //Continue from the checkpoint of a killed run, if there is one
+    Checkpoint cp = create_checkpoint(checkpoint_file, "kahans", t_0, t_end, h, y0, skip_storage, m);
+    std::int64_t first_step = 1;
+    if (load_checkpoint(cp, Y))
+    {
+        y_curr = cp.y_curr.matrix();
+        storage_index = cp.storage_index;
+        first_step = cp.step + 1;
+    }
+
+    //Progress counters for the reporter, if it is running (see telemetry.h)
+    Telemetry tm = create_telemetry("kahans", t_0, t_end, h, y0, n, first_step);
 
     //Compute the system forward in time
-    for (int i = 1; i < n - 1; i++)
+    for (std::int64_t i = first_step; i < n - 1; i++)
     {
         kahans_iteration(y_curr, h, A, b);
         y_curr = A.partialPivLu().solve(b);
@@ -92,11 +98,95 @@ Matrix<double, 4, Dynamic> kahans(const double& t_0, const double& t_end, const
             Y.col(storage_index) = y_curr;
             storage_index++;
         }
+        if (i == cp.next_step)
+        {
+            cp.step = i;
+            cp.storage_index = storage_index;
+            cp.y_curr = y_curr.array();
+            save_checkpoint(cp, Y);
+        }
+        if (i == tm.next_step)
+            update_telemetry(tm, i, y_curr.array(), Y, storage_index);
     }
 
     //Use last_step as step size to compute the last step
     kahans_iteration(y_curr, last_step, A, b);
     Y.col(m-1) = A.partialPivLu().solve(b);
 
+    finish_telemetry(tm, Y.col(m-1).array(), Y);
+    remove_checkpoint(cp);
+
     return Y;
-}
\ No newline at end of file
+}
+
+//Kahan's method compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    kahans, kahans_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file),
+    (t_0, t_end, y0, h, checkpoint_file),
+    Matrix<double, 4, Dynamic>
+)
+
+/**
+ * @brief 
+ * Kahan's method with compressed output, storing the same columns as kahans
+ * compressed block by block (see compressed.h)
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @return CompressedTrajectory the compressed matrix
+ */
+static CompressedTrajectory kahans_compressed_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Matrix<double, 4, 4> A = Matrix<double, 4, 4>::Identity(4, 4);
+    Matrix<double, 4, 1> b = Array<double, 4, 1>::Zero(4);
+
+    return compressed_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            kahans_iteration(y, step_size, A, b);
+            y = A.partialPivLu().solve(b).array();
+        });
+}
+
+//Kahan's method with compressed output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    kahans_compressed, kahans_compressed_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (t_0, t_end, y0, h),
+    CompressedTrajectory
+)
+
+/**
+ * @brief 
+ * Kahan's method with structure-of-arrays output, storing the same columns as kahans
+ * directly into a trajectory (see trajectory.h)
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @return Trajectory
+ */
+static Trajectory kahans_trajectory_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Matrix<double, 4, 4> A = Matrix<double, 4, 4>::Identity(4, 4);
+    Matrix<double, 4, 1> b = Array<double, 4, 1>::Zero(4);
+
+    return trajectory_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            kahans_iteration(y, step_size, A, b);
+            y = A.partialPivLu().solve(b).array();
+        });
+}
+
+//Kahan's method with structure-of-arrays output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    kahans_trajectory, kahans_trajectory_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (t_0, t_end, y0, h),
+    Trajectory
+)
\ No newline at end of file
@@ -2,10 +2,84 @@
 
 //Kahans method of order 2
 
-#include "../utils.h"
+#include "../checkpoint.h"
+#include "../telemetry.h"
+#include "stored_output.h"
 #include <eigen3/Eigen/LU>
 
 void create_A(const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Matrix<double, 4, 4>> A);
 void create_b(const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Matrix<double, 4, 1>> b);
 void kahans_iteration(const Ref<const Array<double, 4, 1>> y_curr, const double& h, Ref<Matrix<double, 4, 4>> A, Ref<Matrix<double, 4, 1>> b);
-Matrix<double, 4, Dynamic> kahans(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
\ No newline at end of file
+Matrix<double, 4, Dynamic> kahans(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file = "");
+CompressedTrajectory kahans_compressed(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+Trajectory kahans_trajectory(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+
+/**
+ * @brief 
+ * Given an identity matrix fill in the rest of the values of A for any potential
+ * 
+ * @param V the potential
+ * @param y current computed values
+ * @param h length of timestep
+ * @param A matrix to be filled
+ */
+template <typename Potential>
+void create_A(const Potential& V, const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Matrix<double, 4, 4>> A)
+{
+    double m11, m12, m21, m22, l1, l2;
+    V.kahan(y[2], y[3], m11, m12, m21, m22, l1, l2);
+
+    A.col(2)[0] = h*m11;
+    A.col(3)[0] = h*m12;
+    A.col(2)[1] = h*m21;
+    A.col(3)[1] = h*m22;
+    A.col(0)[2] = -0.5*h;
+    A.col(1)[3] = -0.5*h;
+}
+
+/**
+ * @brief
+ * Given an array with the same length as y, fill in for b for any potential
+ * 
+ * @param V the potential
+ * @param y current computed values
+ * @param h length of timestep
+ * @param b vector to be filled
+ */
+template <typename Potential>
+void create_b(const Potential& V, const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Matrix<double, 4, 1>> b)
+{
+    double m11, m12, m21, m22, l1, l2;
+    V.kahan(y[2], y[3], m11, m12, m21, m22, l1, l2);
+
+    b[0] = y[0] - 0.5*h*l1;
+    b[1] = y[1] - 0.5*h*l2;
+    b[2] = y[2] + 0.5*h*y[0];
+    b[3] = y[3] + 0.5*h*y[1];
+}
+
+/**
+ * @brief 
+ * Kahan's method for any potential (see potentials.h), compiled for each potential it is used with
+ * 
+ * @param V the potential
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h timestep length
+ * @return mat solution for all time
+ */
+template <typename Potential>
+Matrix<double, 4, Dynamic> kahans(const Potential& V, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Matrix<double, 4, 4> A = Matrix<double, 4, 4>::Identity(4, 4);
+    Matrix<double, 4, 1> b = Array<double, 4, 1>::Zero(4);
+
+    return matrix_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            create_A(V, y, step_size, A);
+            create_b(V, y, step_size, b);
+            y = A.partialPivLu().solve(b).array();
+        });
+}
\ No newline at end of file
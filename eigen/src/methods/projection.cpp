@@ -0,0 +1,116 @@
+#include "projection.h"
+#include "../potentials.h"
+
+#include <chrono>
+#include <cstdint>
+
+/**
+ * @brief 
+ * The hamiltonian of a single state, with the potential of HenonHeiles
+ * 
+ * @param y state of the system
+ * @return double the energy of the state
+ */
+double energy(const Ref<const Array<double, 4, 1>> y)
+{
+    return potential_energy(HenonHeiles(), y);
+}
+
+/**
+ * @brief 
+ * Gradient of the hamiltonian with respect to (p1, p2, q1, q2), the momenta and minus the force
+ * 
+ * @param y state of the system
+ * @param grad the gradient
+ */
+void energy_gradient(const Ref<const Array<double, 4, 1>> y, Ref<Array<double, 4, 1>> grad)
+{
+    double f1, f2;
+    HenonHeiles().force(y[2], y[3], f1, f2);
+
+    grad[0] = y[0];
+    grad[1] = y[1];
+    grad[2] = -f1;
+    grad[3] = -f2;
+}
+
+/**
+ * @brief 
+ * Project a state back onto the energy surface H = H_0, along the gradient
+ * of the hamiltonian at the state, i.e. solve H(y - lam*grad) = H_0 for lam
+ * with Newton's method (usually one or two iterations). A state where the slope along
+ * the gradient is below PROJECTION_MIN_SLOPE (an equilibrium) is not moved
+ * 
+ * @param y state to project
+ * @param H_0 energy to project onto
+ * @return int number of Newton iterations used
+ */
+int project_energy(Ref<Array<double, 4, 1>> y, const double& H_0)
+{
+    Array<double, 4, 1> grad, grad_curr, y_curr;
+    energy_gradient(y, grad);
+
+    double lam = 0;
+    y_curr = y;
+
+    int iterations = 0;
+    for (; iterations < 4; iterations++)
+    {
+        double residual = energy(y_curr) - H_0;
+        if (std::abs(residual) <= 1e-15 * std::abs(H_0))
+            break;
+
+        //d/dlam H(y - lam*grad) = -grad(y - lam*grad) . grad
+        energy_gradient(y_curr, grad_curr);
+        double slope = (grad_curr * grad).sum();
+        if (!(std::abs(slope) > PROJECTION_MIN_SLOPE))
+            break;
+
+        lam += residual / slope;
+        y_curr = y - lam * grad;
+    }
+    y = y_curr;
+
+    return iterations;
+}
+
+
+/**
+ * @brief 
+ * Project a state of a running method onto the energy surface,
+ * and keep track of the cost if stats are given
+ * 
+ * @param y state to project
+ * @param H_0 energy to project onto
+ * @param stats cost of the projections so far (may be nullptr)
+ */
+void projection_step(Ref<Array<double, 4, 1>> y, const double& H_0, ProjectionStats* stats)
+{
+    if (!stats)
+    {
+        project_energy(y, H_0);
+        return;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    stats->iterations += project_energy(y, H_0);
+    stats->seconds += std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    stats->projections++;
+}
+
+/**
+ * @brief 
+ * The first iteration to project after, projections happen
+ * after every iteration divisible by project_every
+ * 
+ * @param first_step first iteration of the run (larger than 1 if resumed from a checkpoint)
+ * @param project_every number of iterations between projections (0 to never project)
+ * @return int64_t the iteration
+ */
+std::int64_t first_projection(const std::int64_t& first_step, const int& project_every)
+{
+    if (project_every <= 0)
+        return INT64_MAX;
+
+    return ((first_step + project_every - 1) / project_every) * project_every;
+}
\ No newline at end of file
@@ -0,0 +1,28 @@
+#pragma once
+
+//Projection of the non-symplectic methods back onto the energy surface H = H_0
+
+#include "../utils.h"
+
+//Smallest slope |dH/dlam| of the energy along the gradient that a projection divides by. At an
+//equilibrium (p = 0 at a critical point of the potential) the gradient vanishes, the energy cannot be
+//corrected along it, and the state is left as it is
+constexpr double PROJECTION_MIN_SLOPE = 1e-12;
+
+//Cost of the projections of one run
+struct ProjectionStats
+{
+    std::int64_t steps = 0;       //Number of steps taken (only those after the checkpoint of a resumed run)
+    std::int64_t projections = 0; //Number of projections performed
+    std::int64_t iterations = 0;  //Number of Newton iterations used by the projections
+    double seconds = 0;           //Time spent projecting
+
+    //Average time spent projecting per step of the run
+    double seconds_per_step() const { return steps ? seconds/steps : 0; }
+};
+
+double energy(const Ref<const Array<double, 4, 1>> y);
+void energy_gradient(const Ref<const Array<double, 4, 1>> y, Ref<Array<double, 4, 1>> grad);
+int project_energy(Ref<Array<double, 4, 1>> y, const double& H_0);
+void projection_step(Ref<Array<double, 4, 1>> y, const double& H_0, ProjectionStats* stats);
+std::int64_t first_projection(const std::int64_t& first_step, const int& project_every);
@@ -9,13 +9,7 @@
  */
 void henon_heiles_sb(const Ref<const Array<double, 4, 1>> y, Ref<Array<double, 4, 1>> Y_vec)
 {
-    double y2 = y[2];
-    double y3 = y[3];
-
-    Y_vec[0] = -y2*(1 + 2*y3);
-    Y_vec[1] = -(y3 + pow(y2, 2) - pow(y3, 2));
-    Y_vec[2] = y[0];
-    Y_vec[3] = y[1];
+    potential_rhs(HenonHeiles(), y, Y_vec);
 
     return;
 }
@@ -31,12 +25,23 @@ void henon_heiles_sb(const Ref<const Array<double, 4, 1>> y, Ref<Array<double, 4
  */
 void sb_iteration(Ref<Array<double, 4, 1>> y_curr, Ref<Matrix<double, 4, 3>> Y_vec, const double& h)
 {
-    // Convert matrix types to array to enable use of coefficient-wise addition
-    henon_heiles_sb(y_curr, Y_vec.col(0));
-    henon_heiles_sb(y_curr + 0.5*h*Y_vec.col(0).array(), Y_vec.col(1));
-    henon_heiles_sb(y_curr + 0.75*h*Y_vec.col(1).array(), Y_vec.col(2));
+    sb_iteration(HenonHeiles(), y_curr, Y_vec, h);
 
-    y_curr = y_curr + h/9 * (2*Y_vec.col(0) + 3*Y_vec.col(1) + 4*Y_vec.col(2)).array();
+    return;
+}
+
+/**
+ * @brief 
+ * Perform the last two stages and the update of an iteration,
+ * given the first stage (the derivative at y_curr) in the first column of Y_vec
+ * 
+ * @param y_curr the current values of the system
+ * @param Y_vec values to compute the three stages of our method 
+ * @param h timestep length
+ */
+void sb_update(Ref<Array<double, 4, 1>> y_curr, Ref<Matrix<double, 4, 3>> Y_vec, const double& h)
+{
+    sb_update(HenonHeiles(), y_curr, Y_vec, h);
 
     return;
 }
@@ -50,19 +55,22 @@ void sb_iteration(Ref<Array<double, 4, 1>> y_curr, Ref<Matrix<double, 4, 3>> Y_v
  * @param t_end End time
  * @param y0 Initial conditions of the system
  * @param h Length of timestep between iterations
+ * @param checkpoint_file File to checkpoint the run to, and resume it from (empty to disable)
+ * @param project_every Project back onto the initial energy after every project_every-th iteration (0 to disable)
+ * @param projection_stats Filled with the cost of the projections (may be nullptr)
  * @return Y matrix
  */
-Matrix<double, 4, Dynamic> shampine_bogacki(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+static Matrix<double, 4, Dynamic> shampine_bogacki_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file, const int& project_every, ProjectionStats* projection_stats)
 {
-    std::tuple<int, int, int, double> vals = create_H(t_0, t_end, h);
-    int n = std::get<0>(vals);
-    int m = std::get<1>(vals);
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    std::int64_t m = std::get<1>(vals);
     int skip_storage = std::get<2>(vals);
     double last_step = std::get<3>(vals);
 
 
     //Init a matrix to be of the same dimension as the init-cond
-    Matrix<double, 4, Dynamic> Y = Matrix<double, 4, Dynamic>::Zero(4, m);
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
     Y.col(0) = y0;
 
     //Our method requires three stored values for each step
@@ -73,22 +81,168 @@ Matrix<double, 4, Dynamic> shampine_bogacki(const double& t_0, const double& t_e
     Array<double, 4, 1> y_curr = y0;
 
     //Index to keep count of where to store in matrix
-    int storage_index = 1;
+    std::int64_t storage_index = 1;
+
+    //Continue from the checkpoint of a killed run, if there is one
+    std::string method = (project_every > 0) ? "sb/projected_" + std::to_string(project_every) : "sb";
+    Checkpoint cp = create_checkpoint(checkpoint_file, method, t_0, t_end, h, y0, skip_storage, m);
+    std::int64_t first_step = 1;
+    if (load_checkpoint(cp, Y))
+    {
+        y_curr = cp.y_curr;
+        storage_index = cp.storage_index;
+        first_step = cp.step + 1;
+    }
+
+    //Progress counters for the reporter, if it is running (see telemetry.h)
+    Telemetry tm = create_telemetry(method, t_0, t_end, h, y0, n, first_step);
+
+    //Energy to project onto, and the next iteration to project after
+    double H_0 = energy(y0);
+    std::int64_t next_projection = first_projection(first_step, project_every);
 
     //Compute the system forward in time
-    for (int i = 1; i < n - 1; i++)
+    for (std::int64_t i = first_step; i < n - 1; i++)
     {
         sb_iteration(y_curr, Y_vec, h);
+        if (i == next_projection)
+        {
+            projection_step(y_curr, H_0, projection_stats);
+            next_projection += project_every;
+        }
         if (!(i % skip_storage))
         {
             Y.col(storage_index) = y_curr;
             storage_index++;
         }
+        if (i == cp.next_step)
+        {
+            cp.step = i;
+            cp.storage_index = storage_index;
+            cp.y_curr = y_curr;
+            save_checkpoint(cp, Y);
+        }
+        if (i == tm.next_step)
+            update_telemetry(tm, i, y_curr, Y, storage_index);
     }
 
     //Use last_step as step size to compute the last step
     sb_iteration(y_curr, Y_vec, last_step);
+    if (project_every > 0)
+        projection_step(y_curr, H_0, projection_stats);
     Y.col(m-1) = y_curr;
 
+    //Only the steps of this run, a resumed run starts after its checkpoint
+    if (projection_stats)
+        projection_stats->steps += n - first_step;
+
+    finish_telemetry(tm, Y.col(m-1).array(), Y);
+    remove_checkpoint(cp);
+
     return Y;
-}
\ No newline at end of file
+}
+
+//Shampine-Bogacki compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    shampine_bogacki, shampine_bogacki_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file, const int& project_every, ProjectionStats* projection_stats),
+    (t_0, t_end, y0, h, checkpoint_file, project_every, projection_stats),
+    Matrix<double, 4, Dynamic>
+)
+
+/**
+ * @brief 
+ * Shampine-Bogacki with dense output, storing the system every dt_out
+ * (independent of h) instead of at every step
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @param dt_out Time between each stored value (see create_T_dense)
+ * @return Y matrix
+ */
+static Matrix<double, 4, Dynamic> shampine_bogacki_dense_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& dt_out)
+{
+    Matrix<double, 4, 3> Y_vec = Matrix<double, 4, 3>::Zero(4, 3);
+
+    Array<double, 4, 1> f0;
+    henon_heiles_sb(y0, f0);
+
+    //The derivative at the end of a step is the first stage of the next one
+    return dense_output(t_0, t_end, y0, h, dt_out, f0, 
+        [&](Ref<Array<double, 4, 1>> y, Ref<Array<double, 4, 1>> f, const double& step_size)
+        {
+            Y_vec.col(0) = f.matrix();
+            sb_update(y, Y_vec, step_size);
+            henon_heiles_sb(y, f);
+        });
+}
+
+//Shampine-Bogacki with dense output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    shampine_bogacki_dense, shampine_bogacki_dense_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& dt_out),
+    (t_0, t_end, y0, h, dt_out),
+    Matrix<double, 4, Dynamic>
+)
+
+/**
+ * @brief 
+ * Shampine-Bogacki with compressed output, storing the same columns as shampine_bogacki
+ * compressed block by block (see compressed.h)
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @return CompressedTrajectory the compressed matrix
+ */
+static CompressedTrajectory shampine_bogacki_compressed_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Matrix<double, 4, 3> Y_vec = Matrix<double, 4, 3>::Zero(4, 3);
+
+    return compressed_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            sb_iteration(y, Y_vec, step_size);
+        });
+}
+
+//Shampine-Bogacki with compressed output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    shampine_bogacki_compressed, shampine_bogacki_compressed_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (t_0, t_end, y0, h),
+    CompressedTrajectory
+)
+
+/**
+ * @brief 
+ * Shampine-Bogacki with structure-of-arrays output, storing the same columns as shampine_bogacki
+ * directly into a trajectory (see trajectory.h)
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @return Trajectory
+ */
+static Trajectory shampine_bogacki_trajectory_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Matrix<double, 4, 3> Y_vec = Matrix<double, 4, 3>::Zero(4, 3);
+
+    return trajectory_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            sb_iteration(y, Y_vec, step_size);
+        });
+}
+
+//Shampine-Bogacki with structure-of-arrays output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    shampine_bogacki_trajectory, shampine_bogacki_trajectory_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (t_0, t_end, y0, h),
+    Trajectory
+)
\ No newline at end of file
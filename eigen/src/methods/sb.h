@@ -2,8 +2,74 @@
 
 //Shampine-Bogacki method of order 3
 
-#include "../utils.h"
+#include "../checkpoint.h"
+#include "../telemetry.h"
+#include "dense.h"
+#include "projection.h"
+#include "stored_output.h"
 
 void henon_heiles_sb(const Ref<const Array<double, 4, 1>> y, Ref<Array<double, 4, 1>> Y_vec);
 void sb_iteration(Ref<Array<double, 4, 1>> y_curr, Ref<Matrix<double, 4, 3>> Y_vec, const double& h);
-Matrix<double, 4, Dynamic> shampine_bogacki(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
\ No newline at end of file
+void sb_update(Ref<Array<double, 4, 1>> y_curr, Ref<Matrix<double, 4, 3>> Y_vec, const double& h);
+Matrix<double, 4, Dynamic> shampine_bogacki(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file = "", const int& project_every = 0, ProjectionStats* projection_stats = nullptr);
+Matrix<double, 4, Dynamic> shampine_bogacki_dense(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& dt_out);
+CompressedTrajectory shampine_bogacki_compressed(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+Trajectory shampine_bogacki_trajectory(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+
+/**
+ * @brief 
+ * Perform the last two stages and the update of an iteration for any potential,
+ * given the first stage (the derivative at y_curr) in the first column of Y_vec
+ * 
+ * @param V the potential
+ * @param y_curr the current values of the system
+ * @param Y_vec values to compute the three stages of our method 
+ * @param h timestep length
+ */
+template <typename Potential>
+void sb_update(const Potential& V, Ref<Array<double, 4, 1>> y_curr, Ref<Matrix<double, 4, 3>> Y_vec, const double& h)
+{
+    potential_rhs(V, y_curr + 0.5*h*Y_vec.col(0).array(), Y_vec.col(1));
+    potential_rhs(V, y_curr + 0.75*h*Y_vec.col(1).array(), Y_vec.col(2));
+
+    y_curr = y_curr + h/9 * (2*Y_vec.col(0) + 3*Y_vec.col(1) + 4*Y_vec.col(2)).array();
+}
+
+/**
+ * @brief 
+ * Perform the three stages of an iteration for any potential
+ * 
+ * @param V the potential
+ * @param y_curr the current values of the system
+ * @param Y_vec values to compute the three stages of our method 
+ * @param h timestep length
+ */
+template <typename Potential>
+void sb_iteration(const Potential& V, Ref<Array<double, 4, 1>> y_curr, Ref<Matrix<double, 4, 3>> Y_vec, const double& h)
+{
+    potential_rhs(V, y_curr, Y_vec.col(0).array());
+    sb_update(V, y_curr, Y_vec, h);
+}
+
+/**
+ * @brief 
+ * Shampine-Bogacki for any potential (see potentials.h), compiled for each potential it is used with
+ * 
+ * @param V the potential
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @return Y matrix
+ */
+template <typename Potential>
+Matrix<double, 4, Dynamic> shampine_bogacki(const Potential& V, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Matrix<double, 4, 3> Y_vec = Matrix<double, 4, 3>::Zero(4, 3);
+
+    return matrix_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            sb_iteration(V, y, Y_vec, step_size);
+        });
+}
\ No newline at end of file
@@ -0,0 +1,145 @@
+#pragma once
+
+//Output of the fixed-step methods into other storage than a matrix:
+//compressed (see compressed.h) or structure-of-arrays (see trajectory.h)
+
+#include "../compressed.h"
+#include "../trajectory.h"
+
+/**
+ * @brief 
+ * Integrate with a fixed step method, and hand every column the method itself
+ * would store to store(j, y), in order
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @param step Performs one step step(y, h)
+ * @param store Stores column j with the values y
+ * @return int64_t number of stored columns
+ */
+template <typename Step, typename Store>
+std::int64_t integrate_stored(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, Step step, Store store)
+{
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    int skip_storage = std::get<2>(vals);
+    double last_step = std::get<3>(vals);
+
+    store(0, y0);
+    std::int64_t storage_index = 1;
+
+    Array<double, 4, 1> y_curr = y0;
+
+    //Compute the system forward in time
+    for (std::int64_t i = 1; i < n - 1; i++)
+    {
+        step(y_curr, h);
+        if (!(i % skip_storage))
+        {
+            store(storage_index, y_curr);
+            storage_index++;
+        }
+    }
+
+    //Use last_step as step size to compute the last step
+    step(y_curr, last_step);
+    store(storage_index, y_curr);
+
+    return storage_index + 1;
+}
+
+/**
+ * @brief 
+ * Integrate with a fixed step method, and store the same columns as the method itself would
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @param step Performs one step step(y, h)
+ * @return Y matrix
+ */
+template <typename Step>
+Matrix<double, 4, Dynamic> matrix_output(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, Step step)
+{
+    std::int64_t m = std::get<1>(create_H(t_0, t_end, h));
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
+    integrate_stored(t_0, t_end, y0, h, step, 
+        [&](const std::int64_t& j, const Ref<const Array<double, 4, 1>> y)
+        {
+            Y.col(j) = y;
+        });
+
+    return Y;
+}
+
+/**
+ * @brief 
+ * Integrate with a fixed step method, and store the same columns as the method itself
+ * would, compressed. Only one block of columns is kept uncompressed at any time
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @param step Performs one step step(y, h)
+ * @return CompressedTrajectory the compressed matrix
+ */
+template <typename Step>
+CompressedTrajectory compressed_output(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, Step step)
+{
+    std::int64_t m = std::get<1>(create_H(t_0, t_end, h));
+
+    CompressedTrajectory C;
+    Matrix<double, 4, Dynamic> block(4, std::min<std::int64_t>(m, COMPRESSED_BLOCK));
+    int cols = 0;
+
+    integrate_stored(t_0, t_end, y0, h, step, 
+        [&](const std::int64_t&, const Ref<const Array<double, 4, 1>> y)
+        {
+            block.col(cols) = y;
+            cols++;
+            if (cols == COMPRESSED_BLOCK)
+            {
+                compress_block(C, block);
+                cols = 0;
+            }
+        });
+
+    //The last (partial) block
+    if (cols)
+        compress_block(C, block.leftCols(cols));
+
+    return C;
+}
+
+/**
+ * @brief 
+ * Integrate with a fixed step method, and store the same columns as the method itself
+ * would, directly into a structure-of-arrays trajectory
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @param step Performs one step step(y, h)
+ * @return Trajectory 
+ */
+template <typename Step>
+Trajectory trajectory_output(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, Step step)
+{
+    std::int64_t m = std::get<1>(create_H(t_0, t_end, h));
+    check_storage(m);
+
+    Trajectory T = create_trajectory(m);
+
+    integrate_stored(t_0, t_end, y0, h, step, 
+        [&](const std::int64_t& j, const Ref<const Array<double, 4, 1>> y)
+        {
+            store_column(T, j, y);
+        });
+
+    return T;
+}
@@ -0,0 +1,27 @@
+#include "sundman.h"
+
+/**
+ * @brief
+ * The time-transformed Störmer-Verlet method with the default rescaling of the force (see sundman.h)
+ *
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param ds length of each step in the fictitious time
+ * @param dt_out time between each stored value (see create_T_dense)
+ * @param alpha weight of the force in the rescaling
+ * @param stats filled with the number of steps and their shortest and longest length in t (may be nullptr)
+ * @return Y matrix with one column for each output time
+ */
+static Matrix<double, 4, Dynamic> sundman_sv_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& ds, const double& dt_out, const double& alpha, SundmanStats* stats)
+{
+    return sundman_sv(ForceRescaling{alpha}, t_0, t_end, y0, ds, dt_out, stats);
+}
+
+//The time-transformed Störmer-Verlet method compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    sundman_sv, sundman_sv_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& ds, const double& dt_out, const double& alpha, SundmanStats* stats),
+    (t_0, t_end, y0, ds, dt_out, alpha, stats),
+    Matrix<double, 4, Dynamic>
+)
@@ -0,0 +1,166 @@
+#pragma once
+
+//Störmer-Verlet with a Sundman time transformation (time-transformed leapfrog, Mikkola and Aarseth)
+//The system is integrated in a fictitious time s with dt = ds/Ω(q), so the steps in t are short where
+//the rescaling function Ω is large. Each step is a drift, kick, drift in s, where the drifts use an
+//auxiliary variable W that follows Ω along the orbit (dW/dt = ∇Ω·p) and the kick uses Ω itself.
+//The step is time symmetric, so the method is reversible and its energy error stays bounded,
+//unlike ordinary adaptive steps. With a constant Ω it is Störmer-Verlet with h = ds/Ω.
+//The system is stored every dt_out by cubic Hermite interpolation, as in stormer_verlet_dense
+
+#include "dense.h"
+
+//Default weight of the force in ForceRescaling
+constexpr double SUNDMAN_ALPHA = 0.1;
+
+//Distance from the origin at which an orbit has escaped for good, and its run ends
+constexpr double SUNDMAN_MAX_RADIUS = 1e3;
+
+struct SundmanStats
+{
+    std::int64_t steps = 0;     //Number of steps
+    double min_dt = INFINITY;   //Shortest step in t
+    double max_dt = 0;          //Longest step in t
+};
+
+//The default rescaling Ω = sqrt(1 + alpha |F|^2) of the Hénon Heiles system, with F the force.
+//The steps shrink where the force is strong, at the turning points and on orbits that escape.
+//Any struct with the same omega function can be used instead (see sundman_sv)
+struct ForceRescaling
+{
+    double alpha = SUNDMAN_ALPHA;
+
+    //Ω at q, and its gradient in g1, g2
+    double omega(const double& q1, const double& q2, double& g1, double& g2) const
+    {
+        double f1, f2;
+        HenonHeiles().force(q1, q2, f1, f2);
+        double omega = std::sqrt(1 + alpha*(f1*f1 + f2*f2));
+
+        //∇|F|^2 = -2 ∇²U F, with the hessian ∇²U of the potential
+        g1 = -alpha * ((1 + 2*q2)*f1 + 2*q1*f2) / omega;
+        g2 = -alpha * (2*q1*f1 + (1 - 2*q2)*f2) / omega;
+
+        return omega;
+    }
+};
+
+Matrix<double, 4, Dynamic> sundman_sv(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& ds, const double& dt_out, const double& alpha = SUNDMAN_ALPHA, SundmanStats* stats = nullptr);
+
+/**
+ * @brief
+ * One step of the time-transformed Störmer-Verlet method. A negative ds steps backwards,
+ * and undoes a step of ds up to rounding
+ *
+ * @param R the rescaling function
+ * @param y the values of the system, replaced by the values after the step
+ * @param W the auxiliary variable (Ω at y before the first step), replaced by its value after the step
+ * @param t the time, replaced by the time after the step
+ * @param ds length of the step in the fictitious time
+ */
+template <typename Rescaling>
+void sundman_sv_step(const Rescaling& R, Ref<Array<double, 4, 1>> y, double& W, double& t, const double& ds)
+{
+    //Drift half a step
+    double dt = 0.5 * ds / W;
+    t += dt;
+    y[2] += dt * y[0];
+    y[3] += dt * y[1];
+
+    //Kick a whole step, and move W along with the mean momentum of the kick
+    double g1, g2, f1, f2;
+    double dt_kick = ds / R.omega(y[2], y[3], g1, g2);
+    HenonHeiles().force(y[2], y[3], f1, f2);
+    double p1 = y[0] + dt_kick * f1;
+    double p2 = y[1] + dt_kick * f2;
+    W += dt_kick * (0.5*(y[0] + p1)*g1 + 0.5*(y[1] + p2)*g2);
+    y[0] = p1;
+    y[1] = p2;
+
+    //Drift half a step
+    dt = 0.5 * ds / W;
+    t += dt;
+    y[2] += dt * y[0];
+    y[3] += dt * y[1];
+}
+
+/**
+ * @brief
+ * The time-transformed Störmer-Verlet method with any rescaling function (see ForceRescaling),
+ * storing the system at the times t_0, t_0 + dt_out, ... (see create_T_dense)
+ *
+ * @param R the rescaling function
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param ds length of each step in the fictitious time, the step in t is about ds/Ω (positive)
+ * @param dt_out time between each stored value (positive)
+ * @param stats filled with the number of steps and their shortest and longest length in t (may be nullptr)
+ * @return Y matrix with one column for each output time
+ */
+template <typename Rescaling>
+Matrix<double, 4, Dynamic> sundman_sv(const Rescaling& R, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& ds, const double& dt_out, SundmanStats* stats = nullptr)
+{
+    //The time only moves forward with positive steps, and the outputs with a positive dt_out
+    if (!(ds > 0) || !(dt_out > 0))
+        throw std::invalid_argument("sundman_sv: ds and dt_out must be positive");
+
+    //Same output times as dense_output
+    std::int64_t m = std::int64_t(std::floor((t_end - t_0)/dt_out + 1e-10)) + 1;
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
+    Y.col(0) = y0;
+
+    double g1, g2;
+    double W = R.omega(y0[2], y0[3], g1, g2);
+    double t = t_0;
+
+    Array<double, 4, 1> y_curr = y0;
+    Array<double, 4, 1> y_prev, f_prev, f_next, y_out;
+
+    //Index of the next output, and its time
+    std::int64_t out_index = 1;
+    double t_out = t_0 + dt_out;
+
+    while (out_index < m)
+    {
+        double t_prev = t;
+        y_prev = y_curr;
+        sundman_sv_step(R, y_curr, W, t, ds);
+        double dt = t - t_prev;
+
+        //An orbit that escapes runs off to infinity in finite time, but the steps shrink along with it
+        //and it would never get there, so the run ends at SUNDMAN_MAX_RADIUS and the rest is nan
+        if (!(y_curr[2]*y_curr[2] + y_curr[3]*y_curr[3] < SUNDMAN_MAX_RADIUS*SUNDMAN_MAX_RADIUS))
+        {
+            Y.rightCols(m - out_index).setConstant(NAN);
+            break;
+        }
+
+        //A step too short to change t would never reach the next output
+        if (!(t > t_prev))
+            throw std::runtime_error("sundman_sv: the time stopped advancing, ds is too short");
+
+        if (stats)
+        {
+            stats->steps++;
+            stats->min_dt = std::min(stats->min_dt, dt);
+            stats->max_dt = std::max(stats->max_dt, dt);
+        }
+
+        //The derivatives are only needed for the steps with an output time in them
+        if (t_out > t)
+            continue;
+
+        potential_rhs(HenonHeiles(), y_prev, f_prev);
+        potential_rhs(HenonHeiles(), y_curr, f_next);
+        while (out_index < m && t_out <= t)
+        {
+            hermite_interpolate(y_prev, f_prev, y_curr, f_next, dt, (t_out - t_prev)/dt, y_out);
+            Y.col(out_index) = y_out;
+            out_index++;
+            t_out = t_0 + out_index*dt_out;
+        }
+    }
+
+    return Y;
+}
@@ -10,18 +10,7 @@
  */
 void henon_heiles_sv(Ref<Array<double, 4, 1>> y_curr, const double& h, Ref<Array<double, 2, 1>> q_next)
 {
-    double p1_half = y_curr[0] + q_next[0];
-    double q1_next = y_curr[2] + h * p1_half;
-    double p2_half = y_curr[1] + q_next[1];
-    double q2_next = y_curr[3] + h * p2_half;
-
-    q_next[0] = 0.5 * h * (-q1_next*(1 + 2*q2_next));
-    q_next[1] = 0.5 * h * (-q2_next - pow(q1_next, 2) + pow(q2_next, 2));
-
-    y_curr[0] = p1_half + q_next[0];
-    y_curr[1] = p2_half + q_next[1];
-    y_curr[2] = q1_next;
-    y_curr[3] = q2_next;
+    henon_heiles_sv(HenonHeiles(), y_curr, h, q_next);
 
     return;
 }
@@ -34,34 +23,47 @@ void henon_heiles_sv(Ref<Array<double, 4, 1>> y_curr, const double& h, Ref<Array
  * @param t_end end time
  * @param y0 initial condition
  * @param h length of timestep
+ * @param checkpoint_file file to checkpoint the run to, and resume it from (empty to disable)
  * @return mat 
  */
-Matrix<double, 4, Dynamic> stormer_verlet(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+static Matrix<double, 4, Dynamic> stormer_verlet_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file)
 {
-    std::tuple<int, int, int, double> vals = create_H(t_0, t_end, h);
-    int n = std::get<0>(vals);
-    int m = std::get<1>(vals);
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    std::int64_t m = std::get<1>(vals);
     int skip_storage = std::get<2>(vals);
     double last_step = std::get<3>(vals);
 
     //Init a matrix to be of the same dimension as the init-cond
-    Matrix<double, 4, Dynamic> Y = Matrix<double, 4, Dynamic>::Zero(4, m);
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
     Y.col(0) = y0;
 
-    Array<double, 2, 1> q_next(
-        0.5 * h * (-y0[2]*(1 + 2*y0[3])), 
-        0.5 * h * (-y0[3] - pow(y0[2], 2) + pow(y0[3], 2))
-    );
+    Array<double, 2, 1> q_next;
+    sv_half_force(HenonHeiles(), y0, h, q_next);
 
     //Since we're not necessarily storing every iteration in the matrix,
     //we need an array to store the current iteration in time
     Array<double, 4, 1> y_curr = y0;
 
     //Index to keep count of where to store in matrix
-    int storage_index = 1;
+    std::int64_t storage_index = 1;
+
+    //Continue from the checkpoint of a killed run, if there is one
+    Checkpoint cp = create_checkpoint(checkpoint_file, "sv", t_0, t_end, h, y0, skip_storage, m);
+    std::int64_t first_step = 1;
+    if (load_checkpoint(cp, Y))
+    {
+        y_curr = cp.y_curr;
+        q_next = cp.carry;
+        storage_index = cp.storage_index;
+        first_step = cp.step + 1;
+    }
+
+    //Progress counters for the reporter, if it is running (see telemetry.h)
+    Telemetry tm = create_telemetry("sv", t_0, t_end, h, y0, n, first_step);
 
     //Compute the system forward in time
-    for (int i = 1; i < n - 1; i++)
+    for (std::int64_t i = first_step; i < n - 1; i++)
     {
         henon_heiles_sv(y_curr, h, q_next);
         if (!(i % skip_storage))
@@ -69,14 +71,145 @@ Matrix<double, 4, Dynamic> stormer_verlet(const double& t_0, const double& t_end
             Y.col(storage_index) = y_curr;
             storage_index++;
         }
+        if (i == cp.next_step)
+        {
+            cp.step = i;
+            cp.storage_index = storage_index;
+            cp.y_curr = y_curr;
+            cp.carry = q_next;
+            save_checkpoint(cp, Y);
+        }
+        if (i == tm.next_step)
+            update_telemetry(tm, i, y_curr, Y, storage_index);
     }
 
     //Use last_step as step size to compute the last step
-    q_next << 0.5 * last_step * (-y_curr[2]*(1 + 2*y_curr[3])), 
-              0.5 * last_step * (-y_curr[3] - pow(y_curr[2], 2) + pow(y_curr[3], 2));
+    sv_half_force(HenonHeiles(), y_curr, last_step, q_next);
 
     henon_heiles_sv(y_curr, last_step, q_next);
     Y.col(m-1) = y_curr;
 
+    finish_telemetry(tm, Y.col(m-1).array(), Y);
+    remove_checkpoint(cp);
+
     return Y;
-}
\ No newline at end of file
+}
+
+//Störmer-Verlet compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    stormer_verlet, stormer_verlet_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file),
+    (t_0, t_end, y0, h, checkpoint_file),
+    Matrix<double, 4, Dynamic>
+)
+
+/**
+ * @brief 
+ * Störmer-Verlet with dense output, storing the system every dt_out
+ * (independent of h) instead of at every step
+ * 
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @param dt_out time between each stored value (see create_T_dense)
+ * @return mat 
+ */
+static Matrix<double, 4, Dynamic> stormer_verlet_dense_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& dt_out)
+{
+    Array<double, 2, 1> q_next;
+    sv_half_force(HenonHeiles(), y0, h, q_next);
+
+    //q_next is half a step of the force, so the derivative comes for free
+    Array<double, 4, 1> f0;
+    f0 << q_next / (0.5 * h), y0[0], y0[1];
+
+    return dense_output(t_0, t_end, y0, h, dt_out, f0, 
+        [&](Ref<Array<double, 4, 1>> y, Ref<Array<double, 4, 1>> f, const double& step_size)
+        {
+            //Only the last step can be shorter than h
+            if (step_size != h)
+                q_next *= step_size / h;
+
+            henon_heiles_sv(y, step_size, q_next);
+            f << q_next / (0.5 * step_size), y[0], y[1];
+        });
+}
+
+//Störmer-Verlet with dense output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    stormer_verlet_dense, stormer_verlet_dense_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& dt_out),
+    (t_0, t_end, y0, h, dt_out),
+    Matrix<double, 4, Dynamic>
+)
+
+/**
+ * @brief 
+ * Störmer-Verlet with compressed output, storing the same columns as stormer_verlet
+ * compressed block by block (see compressed.h)
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @return CompressedTrajectory the compressed matrix
+ */
+static CompressedTrajectory stormer_verlet_compressed_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Array<double, 2, 1> q_next;
+    sv_half_force(HenonHeiles(), y0, h, q_next);
+
+    return compressed_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            //Only the last step can be shorter than h
+            if (step_size != h)
+                sv_half_force(HenonHeiles(), y, step_size, q_next);
+
+            henon_heiles_sv(y, step_size, q_next);
+        });
+}
+
+//Störmer-Verlet with compressed output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    stormer_verlet_compressed, stormer_verlet_compressed_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (t_0, t_end, y0, h),
+    CompressedTrajectory
+)
+
+/**
+ * @brief 
+ * Störmer-Verlet with structure-of-arrays output, storing the same columns as stormer_verlet
+ * directly into a trajectory (see trajectory.h)
+ * 
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Length of timestep between iterations
+ * @return Trajectory
+ */
+static Trajectory stormer_verlet_trajectory_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Array<double, 2, 1> q_next;
+    sv_half_force(HenonHeiles(), y0, h, q_next);
+
+    return trajectory_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            //Only the last step can be shorter than h
+            if (step_size != h)
+                sv_half_force(HenonHeiles(), y, step_size, q_next);
+
+            henon_heiles_sv(y, step_size, q_next);
+        });
+}
+
+//Störmer-Verlet with structure-of-arrays output compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    stormer_verlet_trajectory, stormer_verlet_trajectory_impl,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (t_0, t_end, y0, h),
+    Trajectory
+)
\ No newline at end of file
@@ -2,7 +2,87 @@
 
 //Störmer-Verlet method of order 2
 
-#include "../utils.h"
+#include "../checkpoint.h"
+#include "../telemetry.h"
+#include "dense.h"
+#include "stored_output.h"
 
 void henon_heiles_sv(Ref<Array<double, 4, 1>> y_curr, const double& h, Ref<Array<double, 2, 1>> q_next);
-Matrix<double, 4, Dynamic> stormer_verlet(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
\ No newline at end of file
+Matrix<double, 4, Dynamic> stormer_verlet(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const std::string& checkpoint_file = "");
+Matrix<double, 4, Dynamic> stormer_verlet_dense(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& dt_out);
+CompressedTrajectory stormer_verlet_compressed(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+Trajectory stormer_verlet_trajectory(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
+
+/**
+ * @brief 
+ * One step of the Störmer-Verlet method for any potential
+ * 
+ * @param V the potential
+ * @param y_curr current values of the system
+ * @param h length of timestep
+ * @param q_next half a step of the force, at y_curr before the step and at y_curr after it
+ */
+template <typename Potential>
+void henon_heiles_sv(const Potential& V, Ref<Array<double, 4, 1>> y_curr, const double& h, Ref<Array<double, 2, 1>> q_next)
+{
+    double p1_half = y_curr[0] + q_next[0];
+    double q1_next = y_curr[2] + h * p1_half;
+    double p2_half = y_curr[1] + q_next[1];
+    double q2_next = y_curr[3] + h * p2_half;
+
+    double f1, f2;
+    V.force(q1_next, q2_next, f1, f2);
+    q_next[0] = 0.5 * h * f1;
+    q_next[1] = 0.5 * h * f2;
+
+    y_curr[0] = p1_half + q_next[0];
+    y_curr[1] = p2_half + q_next[1];
+    y_curr[2] = q1_next;
+    y_curr[3] = q2_next;
+}
+
+/**
+ * @brief 
+ * Half a step of the force of a potential, to start a Störmer-Verlet step from y
+ * 
+ * @param V the potential
+ * @param y values of the system
+ * @param h length of timestep
+ * @param q_next filled with half a step of the force
+ */
+template <typename Potential>
+void sv_half_force(const Potential& V, const Ref<const Array<double, 4, 1>> y, const double& h, Ref<Array<double, 2, 1>> q_next)
+{
+    double f1, f2;
+    V.force(y[2], y[3], f1, f2);
+    q_next[0] = 0.5 * h * f1;
+    q_next[1] = 0.5 * h * f2;
+}
+
+/**
+ * @brief 
+ * The Störmer-Verlet method for any potential (see potentials.h), compiled for each potential it is used with
+ * 
+ * @param V the potential
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @return mat 
+ */
+template <typename Potential>
+Matrix<double, 4, Dynamic> stormer_verlet(const Potential& V, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Array<double, 2, 1> q_next;
+    sv_half_force(V, y0, h, q_next);
+
+    return matrix_output(t_0, t_end, y0, h, 
+        [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+        {
+            //Only the last step can be shorter than h
+            if (step_size != h)
+                sv_half_force(V, y, step_size, q_next);
+
+            henon_heiles_sv(V, y, step_size, q_next);
+        });
+}
\ No newline at end of file
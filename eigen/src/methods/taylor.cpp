@@ -0,0 +1,104 @@
+#include "taylor.h"
+
+#include <algorithm>
+#include <cmath>
+
+/**
+ * @brief
+ * The Taylor series method of adaptive order and step (see taylor.h)
+ * implemented for the Hénon Heiles system. The stored columns are at the same times
+ * as those of the fixed step methods with timestep h, evaluated from the series
+ *
+ * @param t_0 Start time
+ * @param t_end End time
+ * @param y0 Initial conditions of the system
+ * @param h Time between the stored columns (before SKIP_STORAGE), not the step size
+ * @param tolerance Local tolerance of each step
+ * @param stats Filled with the number of steps and terms (may be nullptr)
+ * @return Y matrix
+ */
+template <int N>
+static Matrix<double, 4, Dynamic> taylor_impl(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& tolerance, TaylorStats* stats)
+{
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    std::int64_t m = std::get<1>(vals);
+    int skip_storage = std::get<2>(vals);
+
+    Matrix<double, 4, Dynamic> Y = create_Y(m);
+    Y.col(0) = y0;
+
+    //The order only depends on the tolerance, the error of the last terms is about tolerance^2
+    int order = std::clamp(int(std::ceil(-0.5*std::log(tolerance))) + 1, 2, N);
+
+    Array<double, 4, N + 1> X;
+    Array<double, 4, 1> y_curr = y0;
+    Array<double, 4, 1> y_out;
+    double t = t_0;
+
+    //Index of the next column to store, and the iteration of the fixed step methods it belongs to
+    std::int64_t storage_index = 1;
+    std::int64_t next_iteration = skip_storage;
+
+    while (storage_index < m)
+    {
+        taylor_coefficients<N>(y_curr, order, X);
+
+        //Absolute tolerance for small values, relative for large ones
+        double eps = tolerance * std::max(1.0, y_curr.abs().maxCoeff());
+
+        //The step where the last two terms are as small as the tolerance, with a safety factor
+        double rho = INFINITY;
+        for (int j = order - 1; j <= order; j++)
+        {
+            double norm = X.col(j).abs().maxCoeff();
+            if (norm > 0)
+                rho = std::min(rho, std::pow(eps/norm, 1.0/j));
+        }
+        double step = rho * std::exp(-0.7/(order - 1));
+
+        //The last step ends exactly at t_end
+        bool last = !(t + step < t_end);
+        double t_next = last ? t_end : t + step;
+
+        //Store the columns inside this step at the same times as integrate_stored:
+        //the iterations 1, ..., n - 2 of the fixed step methods, and t_end after them
+        while (storage_index < m)
+        {
+            double t_out = (next_iteration < n - 1) ? t_0 + next_iteration*h : t_end;
+            if (t_out > t_next)
+                break;
+
+            taylor_evaluate<N>(X, order, t_out - t, y_out);
+            Y.col(storage_index) = y_out;
+            storage_index++;
+            next_iteration += skip_storage;
+        }
+
+        taylor_evaluate<N>(X, order, t_next - t, y_curr);
+        t = t_next;
+
+        if (stats)
+        {
+            stats->steps++;
+            stats->terms += order;
+        }
+
+        //Never step past t_end, even if fewer columns than m were due
+        if (last)
+            break;
+    }
+
+    if (storage_index < m)
+        return Y.leftCols(storage_index);
+
+    return Y;
+}
+
+//The Taylor series method compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    taylor, taylor_impl<TAYLOR_MAX_ORDER>,
+    (const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& tolerance, TaylorStats* stats),
+    (t_0, t_end, y0, h, tolerance, stats),
+    Matrix<double, 4, Dynamic>
+)
@@ -0,0 +1,74 @@
+#pragma once
+
+//Taylor series method of adaptive order and step
+//The right hand side of the Hénon Heiles system is quadratic, so the Taylor coefficients of the
+//solution follow from Cauchy products of the coefficients before them (see taylor_coefficients).
+//Each step picks the order from the tolerance and the step from the size of the last coefficients
+//(Jorba and Zou), so steps are long and accurate to the tolerance. The values at the output times
+//are evaluated from the series of the step they fall in, independent of the step size
+
+#include "../utils.h"
+
+//Largest order of the series, the coefficients of a step are a fixed size array of this many columns
+constexpr int TAYLOR_MAX_ORDER = 30;
+
+//Default (local) tolerance of each step, absolute for values below 1 and relative above
+constexpr double TAYLOR_TOLERANCE = 1e-16;
+
+struct TaylorStats
+{
+    std::int64_t steps = 0;     //Number of (adaptive) steps
+    std::int64_t terms = 0;     //Sum of the orders of all steps
+};
+
+Matrix<double, 4, Dynamic> taylor(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const double& tolerance = TAYLOR_TOLERANCE, TaylorStats* stats = nullptr);
+
+/**
+ * @brief
+ * The Taylor coefficients of the solution through y, x(t) = sum_k X.col(k) t^k, up to the given order.
+ * With (a*b)_k = sum_j a_j b_(k-j) the Cauchy product, the system gives
+ * q_(k+1) = p_k/(k+1), p1_(k+1) = -(q1_k + 2 (q1*q2)_k)/(k+1) and p2_(k+1) = -(q2_k + (q1*q1)_k - (q2*q2)_k)/(k+1)
+ *
+ * @param y the values of the system
+ * @param order highest coefficient to compute (at most N)
+ * @param X the coefficients, one column for each order
+ */
+template <int N>
+void taylor_coefficients(const Ref<const Array<double, 4, 1>> y, const int& order, Array<double, 4, N + 1>& X)
+{
+    X.col(0) = y;
+
+    for (int k = 0; k < order; k++)
+    {
+        double q1q2 = 0, q1q1 = 0, q2q2 = 0;
+        for (int j = 0; j <= k; j++)
+        {
+            q1q2 += X(2, j) * X(3, k - j);
+            q1q1 += X(2, j) * X(2, k - j);
+            q2q2 += X(3, j) * X(3, k - j);
+        }
+
+        double inv = 1.0 / (k + 1);
+        X(0, k + 1) = -(X(2, k) + 2*q1q2) * inv;
+        X(1, k + 1) = -(X(3, k) + q1q1 - q2q2) * inv;
+        X(2, k + 1) = X(0, k) * inv;
+        X(3, k + 1) = X(1, k) * inv;
+    }
+}
+
+/**
+ * @brief
+ * Evaluate a Taylor series with Horner's scheme
+ *
+ * @param X the coefficients
+ * @param order highest coefficient
+ * @param tau time since the expansion point
+ * @param y the values of the system at tau
+ */
+template <int N>
+void taylor_evaluate(const Array<double, 4, N + 1>& X, const int& order, const double& tau, Ref<Array<double, 4, 1>> y)
+{
+    y = X.col(order);
+    for (int k = order - 1; k >= 0; k--)
+        y = y * tau + X.col(k);
+}
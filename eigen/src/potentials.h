@@ -0,0 +1,193 @@
+#pragma once
+
+#include <eigen3/Eigen/Core>
+
+// Two degree of freedom polynomial potentials U(q1, q2), with H = (p1^2 + p2^2)/2 + U(q1, q2)
+// A potential is a small struct passed by template to the methods, so each potential is
+// compiled into its own copy of the method and there is no runtime dispatch. Every potential has
+//
+//  U(q1, q2)                       the potential (templated, so it also works on whole Eigen arrays)
+//  force(q1, q2, f1, f2)           the force f = -grad U
+//  kahan(q1, q2, m11, m12, m21, m22, l1, l2)
+//                                  the coefficients of the linear system of Kahan's method. With the
+//                                  force written as f_i = -sum_k L_ik q_k - sum_jk C_ijk q_j q_k
+//                                  (C symmetric in j and k), m_ik = L_ik/2 + sum_j C_ijk q_j and l_i = sum_k L_ik q_k
+//
+// The methods without a potential argument use HenonHeiles, and compile to the same code as before
+
+/**
+ * @brief
+ * The Hénon Heiles potential, U = (q1^2 + q2^2)/2 + q1^2 q2 - q2^3/3
+ */
+struct HenonHeiles
+{
+    template <typename T>
+    T U(const T& q1, const T& q2) const
+    {
+        return 0.5*(q1*q1 + q2*q2) + q1*q1*q2 - 1.0/3.0*q2*q2*q2;
+    }
+
+    void force(const double& q1, const double& q2, double& f1, double& f2) const
+    {
+        f1 = -q1*(1 + 2*q2);
+        f2 = -(q2 + q1*q1 - q2*q2);
+    }
+
+    void kahan(const double& q1, const double& q2, double& m11, double& m12, double& m21, double& m22, double& l1, double& l2) const
+    {
+        m11 = q2 + 0.5;
+        m12 = q1;
+        m21 = q1;
+        m22 = 0.5 - q2;
+        l1 = q1;
+        l2 = q2;
+    }
+};
+
+/**
+ * @brief
+ * The Hénon Heiles potential with a general coupling,
+ * U = (q1^2 + q2^2)/2 + lambda (q1^2 q2 - q2^3/3)
+ */
+struct GeneralHenonHeiles
+{
+    double lambda;
+
+    template <typename T>
+    T U(const T& q1, const T& q2) const
+    {
+        return 0.5*(q1*q1 + q2*q2) + lambda*(q1*q1*q2 - 1.0/3.0*q2*q2*q2);
+    }
+
+    void force(const double& q1, const double& q2, double& f1, double& f2) const
+    {
+        f1 = -q1*(1 + 2*lambda*q2);
+        f2 = -(q2 + lambda*(q1*q1 - q2*q2));
+    }
+
+    void kahan(const double& q1, const double& q2, double& m11, double& m12, double& m21, double& m22, double& l1, double& l2) const
+    {
+        m11 = lambda*q2 + 0.5;
+        m12 = lambda*q1;
+        m21 = lambda*q1;
+        m22 = 0.5 - lambda*q2;
+        l1 = q1;
+        l2 = q2;
+    }
+};
+
+/**
+ * @brief
+ * The Contopoulos potential, U = (A q1^2 + B q2^2)/2 - epsilon q1^2 q2
+ */
+struct Contopoulos
+{
+    double A;
+    double B;
+    double epsilon;
+
+    template <typename T>
+    T U(const T& q1, const T& q2) const
+    {
+        return 0.5*(A*q1*q1 + B*q2*q2) - epsilon*q1*q1*q2;
+    }
+
+    void force(const double& q1, const double& q2, double& f1, double& f2) const
+    {
+        f1 = -A*q1 + 2*epsilon*q1*q2;
+        f2 = -B*q2 + epsilon*q1*q1;
+    }
+
+    void kahan(const double& q1, const double& q2, double& m11, double& m12, double& m21, double& m22, double& l1, double& l2) const
+    {
+        m11 = 0.5*A - epsilon*q2;
+        m12 = -epsilon*q1;
+        m21 = -epsilon*q1;
+        m22 = 0.5*B;
+        l1 = A*q1;
+        l2 = B*q2;
+    }
+};
+
+/**
+ * @brief
+ * The Barbanis potential, U = (A q1^2 + B q2^2)/2 - epsilon q1 q2^2
+ */
+struct Barbanis
+{
+    double A;
+    double B;
+    double epsilon;
+
+    template <typename T>
+    T U(const T& q1, const T& q2) const
+    {
+        return 0.5*(A*q1*q1 + B*q2*q2) - epsilon*q1*q2*q2;
+    }
+
+    void force(const double& q1, const double& q2, double& f1, double& f2) const
+    {
+        f1 = -A*q1 + epsilon*q2*q2;
+        f2 = -B*q2 + 2*epsilon*q1*q2;
+    }
+
+    void kahan(const double& q1, const double& q2, double& m11, double& m12, double& m21, double& m22, double& l1, double& l2) const
+    {
+        m11 = 0.5*A;
+        m12 = -epsilon*q2;
+        m21 = -epsilon*q2;
+        m22 = 0.5*B - epsilon*q1;
+        l1 = A*q1;
+        l2 = B*q2;
+    }
+};
+
+/**
+ * @brief
+ * The right hand side of the system of a potential, (p1, p2, q1, q2)' = (f1, f2, p1, p2)
+ *
+ * @param V the potential
+ * @param y the values of the system
+ * @param f the derivatives of the system
+ */
+template <typename Potential>
+inline void potential_rhs(const Potential& V, const Eigen::Ref<const Eigen::Array<double, 4, 1>> y, Eigen::Ref<Eigen::Array<double, 4, 1>> f)
+{
+    double q1 = y[2];
+    double q2 = y[3];
+
+    V.force(q1, q2, f[0], f[1]);
+    f[2] = y[0];
+    f[3] = y[1];
+}
+
+/**
+ * @brief
+ * The energy of a state of the system of a potential, H = (p1^2 + p2^2)/2 + U(q1, q2)
+ *
+ * @param V the potential
+ * @param p1 momentum of q1
+ * @param p2 momentum of q2
+ * @param q1 position
+ * @param q2 position
+ * @return double the energy
+ */
+template <typename Potential>
+inline double potential_energy(const Potential& V, const double& p1, const double& p2, const double& q1, const double& q2)
+{
+    return 0.5*(p1*p1 + p2*p2) + V.U(q1, q2);
+}
+
+/**
+ * @brief
+ * The energy of a state of the system of a potential (see above)
+ *
+ * @param V the potential
+ * @param y the values of the system
+ * @return double the energy
+ */
+template <typename Potential>
+inline double potential_energy(const Potential& V, const Eigen::Ref<const Eigen::Array<double, 4, 1>> y)
+{
+    return potential_energy(V, y[0], y[1], y[2], y[3]);
+}
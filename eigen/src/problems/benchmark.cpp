@@ -0,0 +1,153 @@
+#include "benchmark.h"
+
+#include <chrono>
+
+#include "../constants.h"
+
+//Cost of a run of one of the methods
+struct BenchRun
+{
+    std::int64_t steps = 0;         //Number of steps
+    std::int64_t units = 0;         //Units of work (see BENCH_RHS_PER_UNIT)
+    ProjectionStats projection;     //Cost of the projections of the projected methods
+};
+
+/**
+ * @brief 
+ * Run one of the implemented methods
+ * 
+ * @param method 0 rk4, 1 sb, 2 kahans, 3 sv, 4 projected rk4, 5 projected sb, 6 implicit midpoint,
+ *               7 Gauss-Legendre of order 4, 8 of order 6, 9 Taylor series, 10 Sundman
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param k index of the timestep in bench_h (and of the tolerance in bench_taylor_tolerance)
+ * @param run Filled with the cost of the run
+ * @return Matrix<double, 4, Dynamic> the computed matrix
+ */
+static Matrix<double, 4, Dynamic> run_method(const int& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const int& k, BenchRun& run)
+{
+    const double h = bench_h[k];
+
+    //The fixed step methods take the same steps as create_H, one unit of work each
+    run.steps = std::get<0>(create_H(t_0, t_end, h)) - 1;
+    run.units = run.steps;
+
+    switch (method)
+    {
+        case 0:
+            return kuttas_method(t_0, t_end, y0, h, "");
+        case 1:
+            return shampine_bogacki(t_0, t_end, y0, h, "");
+        case 2:
+            return kahans(t_0, t_end, y0, h, "");
+        case 3:
+            return stormer_verlet(t_0, t_end, y0, h, "");
+        case 4:
+            return kuttas_method(t_0, t_end, y0, h, "", bench_project_every, &run.projection);
+        case 5:
+            return shampine_bogacki(t_0, t_end, y0, h, "", bench_project_every, &run.projection);
+        case 6:
+        case 7:
+        case 8:
+        {
+            GaussStats stats;
+            Matrix<double, 4, Dynamic> Y = (method == 6) ? implicit_midpoint(t_0, t_end, y0, h, &stats)
+                                         : (method == 7) ? gauss_legendre_4(t_0, t_end, y0, h, &stats)
+                                         :                 gauss_legendre_6(t_0, t_end, y0, h, &stats);
+            run.units = stats.iterations;
+            return Y;
+        }
+        case 9:
+        {
+            TaylorStats stats;
+            Matrix<double, 4, Dynamic> Y = taylor(t_0, t_end, y0, bench_dt_out, bench_taylor_tolerance[k], &stats);
+            run.steps = stats.steps;
+            run.units = stats.terms;
+            return Y;
+        }
+        default:
+        {
+            SundmanStats stats;
+            Matrix<double, 4, Dynamic> Y = sundman_sv(t_0, t_end, y0, h, bench_dt_out, SUNDMAN_ALPHA, &stats);
+            run.steps = stats.steps;
+            run.units = stats.steps;
+            return Y;
+        }
+    }
+}
+
+/**
+ * @brief 
+ * Compute the work-precision table of the implemented methods (see benchmark.h).
+ * The wall time of a run is the fastest of bench_repeats runs, and the global error is
+ * the distance from the reference at t_end
+ * 
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @return Matrix<double, Dynamic, BENCH_COLS> the table, one row for each method and timestep
+ */
+Matrix<double, Dynamic, BENCH_COLS> work_precision(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0)
+{
+    constexpr int n_h = sizeof(bench_h)/sizeof(bench_h[0]);
+    static_assert(sizeof(bench_taylor_tolerance) == sizeof(bench_h), "bench_taylor_tolerance needs one tolerance for each timestep");
+    static_assert(sizeof(BENCH_RHS_PER_UNIT)/sizeof(BENCH_RHS_PER_UNIT[0]) == BENCH_METHODS, "BENCH_RHS_PER_UNIT needs one value for each method");
+
+    //Only the end points are stored, the reference takes its own (long) steps
+    Matrix<double, 4, Dynamic> Y_ref = taylor(t_0, t_end, y0, t_end - t_0, bench_tolerance);
+    Array<double, 4, 1> y_ref = Y_ref.col(Y_ref.cols() - 1);
+    double H_0 = energy(y0);
+
+    Matrix<double, Dynamic, BENCH_COLS> table(BENCH_METHODS*n_h, BENCH_COLS);
+
+    //The runs are timed one at a time, so they do not compete for cores or memory bandwidth
+    for (int method = 0; method < BENCH_METHODS; method++)
+    {
+        for (int k = 0; k < n_h; k++)
+        {
+            double seconds = INFINITY;
+            Matrix<double, 4, Dynamic> Y;
+            BenchRun fastest;
+            for (int r = 0; r < bench_repeats; r++)
+            {
+                BenchRun run;
+                auto start = std::chrono::steady_clock::now();
+                Y = run_method(method, t_0, t_end, y0, k, run);
+                double run_seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+                //The cost of the fastest run
+                if (run_seconds < seconds)
+                {
+                    seconds = run_seconds;
+                    fastest = run;
+                }
+            }
+
+            Array<double, 4, 1> y_end = Y.col(Y.cols() - 1);
+            double h = (method == 9) ? bench_taylor_tolerance[k] : bench_h[k];
+
+            Matrix<double, 1, BENCH_COLS> row;
+            row << method, h, double(fastest.steps), double(fastest.units*BENCH_RHS_PER_UNIT[method]), seconds,
+                (y_end - y_ref).matrix().norm(), (hamiltonian(Y) - H_0).abs().maxCoeff(),
+                double(fastest.projection.iterations), fastest.projection.seconds;
+            table.row(method*n_h + k) = row;
+        }
+    }
+
+    return table;
+}
+
+/**
+ * @brief 
+ * Compute the work-precision table of the implemented methods,
+ * and save it in a file (see work_precision_file)
+ * 
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ */
+void compute_work_precision(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0)
+{
+    matrix_to_CSV(work_precision_file, work_precision(t_0, t_end, y0));
+}
@@ -0,0 +1,33 @@
+#pragma once
+
+#include "compute.h"
+
+//Work-precision benchmark of the implemented methods
+//Every method is run with every timestep in bench_h (see constants.h), and its cost (wall time and
+//evaluations of the right hand side) is compared with its global error against a reference run
+//of the Taylor series method (see methods/taylor.h), and with its largest energy error
+
+//Kutta's method and Shampine-Bogacki are also run projected onto the energy surface every
+//bench_project_every-th step (see methods/projection.h), and the cost of the projections is reported.
+//The Taylor series method takes its own steps, and is run with the tolerances in bench_taylor_tolerance
+//instead of the timesteps. The Sundman method uses the timestep as its step ds in the fictitious time.
+//Both store their values every bench_dt_out
+
+//Columns of the work-precision table, one row for each method and timestep
+//method (see BENCH_RHS_PER_UNIT), h (the tolerance for the Taylor series method), steps, rhs evaluations,
+//wall time [s], global error, energy error, Newton iterations of the projections, time spent projecting [s]
+constexpr int BENCH_COLS = 9;
+
+//Number of methods in the table
+constexpr int BENCH_METHODS = 11;
+
+//Evaluations of the right hand side in each unit of work of every method: a step of rk4, sb, kahans, sv,
+//the projected rk4 and sb (0-5) and the Sundman method (10), a Newton iteration of the implicit midpoint
+//rule and the Gauss-Legendre methods of order 4 and 6 (6-8), and a term of the Taylor series (9, the
+//terms are Cauchy products, about as costly as an evaluation). Kahan's method evaluates the quadratic
+//part of the force once, to set up its linear system, and the Sundman method evaluates the force
+//for the kick and for the rescaling function
+constexpr int BENCH_RHS_PER_UNIT[] = {4, 3, 1, 1, 4, 3, 1, 2, 3, 1, 2};
+
+Matrix<double, Dynamic, BENCH_COLS> work_precision(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0);
+void compute_work_precision(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0);
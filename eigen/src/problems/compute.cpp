@@ -1,5 +1,69 @@
 #include "compute.h"
 
+/**
+ * @brief
+ * Create the tasks computing the hamiltonian and/or Poincaré map of one method (see compute_both).
+ * The results that are already in the cache (see cache.h) are copied from it, and the trajectory
+ * is only integrated (or mapped from the cache, with CACHE_TRAJECTORIES) if a result is missing.
+ * Each result computed is stored in the cache, and the trajectory is freed as soon as the results
+ * are done with it
+ *
+ * @param method name of the method in the cache
+ * @param integrate Integrates the system, integrate()
+ * @param Y the trajectory, must outlive the tasks
+ * @param H the hamiltonian, must outlive the tasks (unused unless with_hamiltonian)
+ * @param P the Poincaré map, must outlive the tasks (unused unless with_poincare)
+ * @param with_hamiltonian compute the hamiltonian
+ * @param with_poincare compute the Poincaré map
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition for system
+ * @param h length of timestep
+ */
+template <typename Method>
+static void method_tasks(const std::string& method, Method integrate, CachedResult<4>& Y, Ref<Array<double, Dynamic, 1>> H, Matrix<double, 2, Dynamic>& P, const bool& with_hamiltonian, const bool& with_poincare, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    std::string key_Y = cache_key("trajectory", method, t_0, t_end, y0, h);
+    std::string key_H = cache_key("hamiltonian", method, t_0, t_end, y0, h);
+    std::string key_P = cache_key("poincare", method, t_0, t_end, y0, h);
+
+    bool need_H = with_hamiltonian && !cache_copy(key_H, H);
+    bool need_P = with_poincare && !cache_copy(key_P, P);
+    if (!need_H && !need_P)
+        return;
+
+    #pragma omp task depend(out: Y) shared(Y)
+    cached_result(Y, key_Y, integrate, CACHE_TRAJECTORIES);
+
+    //The trajectory is written alongside the analyses, instead of delaying them
+    if (CACHE_TRAJECTORIES)
+    {
+        #pragma omp task depend(in: Y) shared(Y)
+        store_result(Y, key_Y);
+    }
+
+    if (need_H)
+    {
+        #pragma omp task depend(in: Y) shared(Y)
+        {
+            hamiltonian(Y.view(), H);
+            cache_store(key_H, H.matrix());
+        }
+    }
+
+    if (need_P)
+    {
+        #pragma omp task depend(in: Y) shared(Y, P)
+        {
+            P = poincare(Y.view());
+            cache_store(key_P, P);
+        }
+    }
+
+    #pragma omp task depend(inout: Y) shared(Y)
+    release_result(Y);
+}
+
 /**
  * @brief 
  * Compute the hamiltonians for all the implemented methods,
@@ -17,28 +81,32 @@ void compute_hamiltonians(const double& t_0, const double& t_end, const Ref<cons
 
     //Matrix containing the time in the first column and hamiltonians of all methods in the second
     //Should have n rows (number of time steps) and the number of methods + 1 columns
-    Matrix<double, Dynamic, 5> H = Matrix<double, Dynamic, 5>::Zero(T.size(), 5);
+    Matrix<double, Dynamic, 5> H(T.size(), 5);
     H.col(0) = T;
 
+    //Trajectories and (unused) Poincaré maps of the methods
+    CachedResult<4> Y_rk, Y_sb, Y_kahans, Y_sv;
+    Matrix<double, 2, Dynamic> P;
+
     #pragma omp parallel
     {
         #pragma omp single nowait
         {
             // Compute the hamiltonian of Kutta's method
-            #pragma omp task
-            H.col(1) = hamiltonian(kuttas_method(t_0, t_end, y0, h));
+            method_tasks("rk4", [&]() { return kuttas_method(t_0, t_end, y0, h, checkpoint_file_rk4); },
+                Y_rk, H.col(1).array(), P, true, false, t_0, t_end, y0, h);
 
             // Compute the hamiltonian of Shampine-Bogacki
-            #pragma omp task
-            H.col(2) = hamiltonian(shampine_bogacki(t_0, t_end, y0, h));
+            method_tasks("sb", [&]() { return shampine_bogacki(t_0, t_end, y0, h, checkpoint_file_sb); },
+                Y_sb, H.col(2).array(), P, true, false, t_0, t_end, y0, h);
 
             // Compute the hamiltonian of Kahans method
-            #pragma omp task
-            H.col(3) = hamiltonian(kahans(t_0, t_end, y0, h));
+            method_tasks("kahans", [&]() { return kahans(t_0, t_end, y0, h, checkpoint_file_kahans); },
+                Y_kahans, H.col(3).array(), P, true, false, t_0, t_end, y0, h);
 
             // Compute the hamiltonian of Störmer-Verlet
-            #pragma omp task
-            H.col(4)  = hamiltonian(stormer_verlet(t_0, t_end, y0, h));
+            method_tasks("sv", [&]() { return stormer_verlet(t_0, t_end, y0, h, checkpoint_file_sv); },
+                Y_sv, H.col(4).array(), P, true, false, t_0, t_end, y0, h);
         }
     }
     #pragma omp taskwait
@@ -63,25 +131,29 @@ void compute_poincare_maps(const double& t_0, const double& t_end, const Ref<con
     //Declare the matrices to store results in
     Matrix<double, 2, Dynamic> P_rk, P_sb, P_kahans, P_sv;
 
+    //Trajectories and (unused) hamiltonian of the methods
+    CachedResult<4> Y_rk, Y_sb, Y_kahans, Y_sv;
+    Array<double, Dynamic, 1> H;
+
     #pragma omp parallel
     {
         #pragma omp single nowait
         {
             // Find the Poincaré map of Kutta's method
-            #pragma omp task
-            P_rk = poincare(kuttas_method(t_0, t_end, y0, h));
+            method_tasks("rk4", [&]() { return kuttas_method(t_0, t_end, y0, h, checkpoint_file_rk4); },
+                Y_rk, H, P_rk, false, true, t_0, t_end, y0, h);
 
             // Find the Poincaré map of Shampine-Bogacki
-            #pragma omp task
-            P_sb = poincare(shampine_bogacki(t_0, t_end, y0, h));
+            method_tasks("sb", [&]() { return shampine_bogacki(t_0, t_end, y0, h, checkpoint_file_sb); },
+                Y_sb, H, P_sb, false, true, t_0, t_end, y0, h);
 
             // Find the Poincaré map of Kahans method
-            #pragma omp task
-            P_kahans = poincare(kahans(t_0, t_end, y0, h));
+            method_tasks("kahans", [&]() { return kahans(t_0, t_end, y0, h, checkpoint_file_kahans); },
+                Y_kahans, H, P_kahans, false, true, t_0, t_end, y0, h);
 
             // Find the Poincaré map of Störmer-Verlet
-            #pragma omp task
-            P_sv = poincare(stormer_verlet(t_0, t_end, y0, h));
+            method_tasks("sv", [&]() { return stormer_verlet(t_0, t_end, y0, h, checkpoint_file_sv); },
+                Y_sv, H, P_sv, false, true, t_0, t_end, y0, h);
         }
     }
     #pragma omp taskwait
@@ -108,85 +180,44 @@ void compute_poincare_maps(const double& t_0, const double& t_end, const Ref<con
  */
 void compute_both(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
 {
-    //Matrices to store 
-    Matrix<double, 4, Dynamic> Y_rk, Y_sb, Y_kahans, Y_sv;
+    //Matrices to store (the trajectories may be mapped from the cache, see cache.h)
+    CachedResult<4> Y_rk, Y_sb, Y_kahans, Y_sv;
     Matrix<double, 2, Dynamic> P_rk, P_sb, P_kahans, P_sv;
 
-    //Compute the Hénon-Heiles system for each of the implemented method
-    //in parallel first, as each of them will be used twice in the 
-    //subsequent computation part
-    #pragma omp parallel
-    {
-        #pragma omp single nowait
-        {
-            // Compute the Hénon-Heiles system with Kutta's method
-            #pragma omp task
-            Y_rk = kuttas_method(t_0, t_end, y0, h);
-
-            // Compute the Hénon-Heiles system with Shampine-Bogacki
-            #pragma omp task
-            Y_sb = shampine_bogacki(t_0, t_end, y0, h);
-
-            // Compute the Hénon-Heiles system with Kahans method
-            #pragma omp task
-            Y_kahans = kahans(t_0, t_end, y0, h);
-
-            // Compute the Hénon-Heiles system with Störmer-Verlet
-            #pragma omp task
-            Y_sv = stormer_verlet(t_0, t_end, y0, h);
-        }
-    }
-    #pragma omp taskwait
-
     //Time array
     Array<double, Dynamic, 1> T = create_T(t_0, t_end, h);
 
     //Matrix containing the time in the first column and hamiltonians of all methods in the second
     //Should have n rows (number of time steps) and the number of methods + 1 columns
-    Matrix<double, Dynamic, 5> H = Matrix<double, Dynamic, 5>::Zero(T.size(), 5);
+    Matrix<double, Dynamic, 5> H(T.size(), 5);
 
     //Add the time vector to our matrix
     H.col(0) = T;
 
-    //Compute the hamiltonians and the Poincaré maps for each implemented method in parallel
+    //All the work is one graph of tasks: the hamiltonian and Poincaré map of a method
+    //start as soon as its own computation is done (not when the slowest method is done),
+    //and each computed matrix is freed as soon as both of them are done with it (see method_tasks)
     #pragma omp parallel
     {
         #pragma omp single nowait
         {
-            // Compute the hamiltonian of Kutta's method
-            #pragma omp task
-            H.col(1) = hamiltonian(Y_rk);
+            // Compute the hamiltonian and Poincaré map of Kutta's method
+            method_tasks("rk4", [&]() { return kuttas_method(t_0, t_end, y0, h, checkpoint_file_rk4); },
+                Y_rk, H.col(1).array(), P_rk, true, true, t_0, t_end, y0, h);
 
-            // Compute the hamiltonian of Shampine-Bogacki
-            #pragma omp task
-            H.col(2) = hamiltonian(Y_sb);
-
-            // Compute the hamiltonian of Kahans method
-            #pragma omp task
-            H.col(3) = hamiltonian(Y_kahans);
-
-            // Compute the hamiltonian of Störmer-Verlet
-            #pragma omp task
-            H.col(4) = hamiltonian(Y_sv);
-
-            // Find the Poincaré map of Kutta's method
-            #pragma omp task
-            P_rk = poincare(Y_rk);
-
-            // Find the Poincaré map of Shampine-Bogacki
-            #pragma omp task
-            P_sb = poincare(Y_sb);
+            // Compute the hamiltonian and Poincaré map of Shampine-Bogacki
+            method_tasks("sb", [&]() { return shampine_bogacki(t_0, t_end, y0, h, checkpoint_file_sb); },
+                Y_sb, H.col(2).array(), P_sb, true, true, t_0, t_end, y0, h);
 
-            // Find the Poincaré map of Kahans method
-            #pragma omp task
-            P_kahans = poincare(Y_kahans);
+            // Compute the hamiltonian and Poincaré map of Kahans method
+            method_tasks("kahans", [&]() { return kahans(t_0, t_end, y0, h, checkpoint_file_kahans); },
+                Y_kahans, H.col(3).array(), P_kahans, true, true, t_0, t_end, y0, h);
 
-            // Find the Poincaré map of Störmer-Verlet
-            #pragma omp task
-            P_sv = poincare(Y_sv);
+            // Compute the hamiltonian and Poincaré map of Störmer-Verlet
+            method_tasks("sv", [&]() { return stormer_verlet(t_0, t_end, y0, h, checkpoint_file_sv); },
+                Y_sv, H.col(4).array(), P_sv, true, true, t_0, t_end, y0, h);
         }
     }
-    #pragma omp taskwait
 
     //Uncomment the line(s) below if you actaully want the output
     // matrix_to_CSV(hamiltonians_file + decimal_to_string(h), H);
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../cache.h"
 #include "hamiltonian.h"
 #include "poincare.h"
 
@@ -0,0 +1,191 @@
+#include "ensemble.h"
+
+#include <cstdio>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief
+ * Map a binary file of initial conditions into memory (see ensemble.h), read only
+ *
+ * @param file path of the file
+ * @param width doubles in each row, 4 (p1, p2, q1, q2) or 6 (followed by h and t_end)
+ * @return InitialConditions the mapped rows
+ */
+InitialConditions map_initial_conditions(const std::string& file, const int& width)
+{
+    if (width != 4 && width != 6)
+        throw std::invalid_argument("map_initial_conditions: rows have 4 or 6 values, not " + std::to_string(width));
+
+    int fd = open(file.c_str(), O_RDONLY);
+    if (fd < 0)
+        throw std::runtime_error("map_initial_conditions: cannot open " + file);
+
+    struct stat st;
+    if (fstat(fd, &st) < 0)
+    {
+        close(fd);
+        throw std::runtime_error("map_initial_conditions: cannot stat " + file);
+    }
+
+    InitialConditions ic;
+    ic.width = width;
+    ic.bytes = std::size_t(st.st_size);
+    if (ic.bytes % (width*sizeof(double)))
+    {
+        close(fd);
+        throw std::invalid_argument("map_initial_conditions: the size of " + file + " is not a whole number of rows");
+    }
+    ic.rows = std::int64_t(ic.bytes / (width*sizeof(double)));
+
+    //An empty file has no rows, and cannot be mapped
+    if (ic.bytes)
+    {
+        void* p = mmap(nullptr, ic.bytes, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (p == MAP_FAILED)
+        {
+            close(fd);
+            throw std::runtime_error("map_initial_conditions: cannot map " + file);
+        }
+        //The batches are read front to back, so the kernel may read ahead
+        madvise(p, ic.bytes, MADV_SEQUENTIAL);
+        ic.data = static_cast<const double*>(p);
+    }
+
+    //The mapping stays valid without the descriptor
+    close(fd);
+
+    return ic;
+}
+
+/**
+ * @brief
+ * Unmap the initial conditions of map_initial_conditions
+ *
+ * @param ic the mapped rows
+ */
+void unmap_initial_conditions(InitialConditions& ic)
+{
+    if (ic.data)
+        munmap(const_cast<double*>(ic.data), ic.bytes);
+
+    ic = InitialConditions();
+}
+
+/**
+ * @brief
+ * Integrate one orbit of an ensemble without storing it, and analyse it like compute_streaming
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param ic the mapped rows
+ * @param row the orbit
+ * @param t_0 start time
+ * @param t_end end time, unless the row has its own
+ * @param h length of timestep, unless the row has its own
+ * @return the results of the orbit (see ENSEMBLE_COLS), flagged if the row is not valid (see ENSEMBLE_MAX_STEPS)
+ */
+Matrix<double, 1, ENSEMBLE_COLS> ensemble_orbit(const std::string& method, const InitialConditions& ic, const std::int64_t& row, const double& t_0, const double& t_end, const double& h)
+{
+    //The row is read in place from the mapping
+    const double* r = ic.data + row*ic.width;
+    Eigen::Map<const Array<double, 4, 1>> y0(r);
+    double h_row = (ic.width == 6) ? r[4] : h;
+    double t_end_row = (ic.width == 6) ? r[5] : t_end;
+
+    Matrix<double, 1, ENSEMBLE_COLS> result;
+
+    //A bad row is flagged instead of thrown, which would end the whole ensemble inside the parallel loop
+    double steps = (t_end_row - t_0)/h_row;
+    if (!y0.isFinite().all() || !(h_row > 0) || !(t_end_row > t_0) || !(steps <= ENSEMBLE_MAX_STEPS))
+    {
+        result << double(row), h_row, t_end_row, NAN, NAN, -1;
+        return result;
+    }
+
+    double H_0 = energy(y0);
+    double max_drift = 0, final_drift = 0;
+    std::int64_t crossings = 0;
+    double q1_prev = y0[2];
+
+    stream_method(method, t_0, t_end_row, y0, h_row,
+        [&](const std::int64_t& j, const Ref<const Array<double, 4, 1>> y)
+        {
+            double drift = energy(y) - H_0;
+            max_drift = std::max(max_drift, std::abs(drift));
+            final_drift = drift;
+
+            //Same crossing as poincare()
+            if (j > 0 && y[0] > 0 && y[2] * q1_prev < 0)
+                crossings++;
+            q1_prev = y[2];
+        });
+
+    result << double(row), h_row, t_end_row, max_drift, final_drift, double(crossings);
+
+    return result;
+}
+
+/**
+ * @brief
+ * Integrate every orbit of a binary file of initial conditions in parallel batches, and append the
+ * results of each batch to ensemble_file as soon as it is done (see ensemble.h)
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param file path of the initial conditions
+ * @param width doubles in each row, 4 or 6 (with h and t_end)
+ * @param t_0 start time
+ * @param t_end end time of the rows without their own
+ * @param h length of timestep of the rows without their own
+ * @return int64_t number of orbits
+ */
+std::int64_t compute_ensemble(const std::string& method, const std::string& file, const int& width, const double& t_0, const double& t_end, const double& h)
+{
+    //An unknown method would only throw inside the parallel loop
+    if (method != "rk4" && method != "sb" && method != "kahans" && method != "sv")
+        throw std::invalid_argument("compute_ensemble: unknown method " + method);
+
+    InitialConditions ic = map_initial_conditions(file, width);
+    std::int64_t n_batches = (ic.rows + ENSEMBLE_BATCH - 1) / ENSEMBLE_BATCH;
+
+    std::FILE* out = std::fopen(ensemble_file.c_str(), "w");
+    if (!out)
+        throw std::runtime_error("compute_ensemble: cannot open " + ensemble_file);
+
+    //Orbits of different lengths take different times, so the batches are handed out dynamically
+    #pragma omp parallel for schedule(dynamic, 1)
+    for (std::int64_t b = 0; b < n_batches; b++)
+    {
+        std::int64_t first = b*ENSEMBLE_BATCH;
+        std::int64_t rows = std::min<std::int64_t>(ENSEMBLE_BATCH, ic.rows - first);
+
+        Matrix<double, Dynamic, ENSEMBLE_COLS> results(rows, ENSEMBLE_COLS);
+        for (std::int64_t k = 0; k < rows; k++)
+            results.row(k) = ensemble_orbit(method, ic, first + k, t_0, t_end, h);
+
+        //Format outside the critical section, so the threads only wait for each other's writes
+        //(printf, since the aligned columns of Eigen's format take longer than the orbits)
+        std::string batch;
+        char line[256];
+        for (std::int64_t k = 0; k < rows; k++)
+        {
+            int len = std::snprintf(line, sizeof(line), "%lld, %.10g, %.10g, %.10g, %.10g, %lld\n",
+                (long long)results(k, 0), results(k, 1), results(k, 2), results(k, 3), results(k, 4), (long long)results(k, 5));
+            batch.append(line, len);
+        }
+
+        #pragma omp critical(ensemble_output)
+        {
+            std::fwrite(batch.data(), 1, batch.size(), out);
+            std::fflush(out);
+        }
+    }
+
+    std::fclose(out);
+
+    std::int64_t rows = ic.rows;
+    unmap_initial_conditions(ic);
+
+    return rows;
+}
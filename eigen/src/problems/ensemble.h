@@ -0,0 +1,34 @@
+#pragma once
+
+#include "streaming.h"
+
+//Ensembles of initial conditions read from a binary file, for orbits sampled elsewhere
+//The file is a plain array of little endian doubles, one row per orbit: p1, p2, q1, q2, and
+//optionally the timestep h and end time t_end of the orbit (e.g. numpy's tofile()).
+//The file is mapped into memory and the rows are read in place, so nothing is parsed or copied
+//before the orbits start, whatever the size of the ensemble. The orbits are integrated in batches
+//of ENSEMBLE_BATCH rows by the threads, and the results of each batch are appended to the results
+//file as soon as it is done, keyed by row (so the rows of the results are not in order)
+
+//Number of orbits a thread takes at a time, and writes the results of at once
+constexpr int ENSEMBLE_BATCH = 256;
+
+//Results of an orbit: row, h, t_end, largest |H - H_0|, H - H_0 at t_end, number of Poincaré crossings
+constexpr int ENSEMBLE_COLS = 6;
+
+//Most steps an orbit may take. A row that is not finite, has h <= 0, ends before it starts or would take
+//more steps is not integrated: its drifts are NaN and its crossings -1, and the other rows go on
+constexpr double ENSEMBLE_MAX_STEPS = 1e12;
+
+struct InitialConditions
+{
+    const double* data = nullptr;   //The mapped rows
+    std::int64_t rows = 0;          //Number of orbits
+    int width = 4;                  //Doubles in each row, 4 or 6 (with h and t_end)
+    std::size_t bytes = 0;          //Size of the mapping
+};
+
+InitialConditions map_initial_conditions(const std::string& file, const int& width);
+void unmap_initial_conditions(InitialConditions& ic);
+Matrix<double, 1, ENSEMBLE_COLS> ensemble_orbit(const std::string& method, const InitialConditions& ic, const std::int64_t& row, const double& t_0, const double& t_end, const double& h);
+std::int64_t compute_ensemble(const std::string& method, const std::string& file, const int& width, const double& t_0, const double& t_end, const double& h);
@@ -0,0 +1,171 @@
+#include "escape.h"
+
+#include <algorithm>
+#include <vector>
+
+#include "../constants.h"
+
+/**
+ * @brief
+ * The exit channel of a point outside the saddles, the saddle in the direction nearest to it
+ *
+ * @param q1 position
+ * @param q2 position
+ * @return int 0 upper (0, 1), 1 lower left (-sqrt(3)/2, -1/2), 2 lower right (sqrt(3)/2, -1/2)
+ */
+int escape_channel(const double& q1, const double& q2)
+{
+    const double s = std::sqrt(3.0)/2;
+    double up = q2;
+    double left = -s*q1 - 0.5*q2;
+    double right = s*q1 - 0.5*q2;
+
+    if (up >= left && up >= right)
+        return 0;
+    return (left >= right) ? 1 : 2;
+}
+
+/**
+ * @brief
+ * Integrate an orbit with Störmer-Verlet until it escapes, or until t_max
+ *
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @param t_max longest time to integrate
+ * @param t_escape the escape time, or t_max if the orbit is trapped
+ * @return int the exit channel (see escape_channel), or ESCAPE_TRAPPED
+ */
+static int escape_orbit_impl(const Ref<const Array<double, 4, 1>> y0, const double& h, const double& t_max, double& t_escape)
+{
+    const std::int64_t n = std::int64_t(std::ceil(t_max/h));
+    const double r_sq = ESCAPE_RADIUS*ESCAPE_RADIUS;
+
+    Array<double, 4, 1> y = y0;
+    Array<double, 2, 1> q_next;
+    sv_half_force(HenonHeiles(), y, h, q_next);
+
+    for (std::int64_t i = 1; i <= n; i++)
+    {
+        henon_heiles_sv(HenonHeiles(), y, h, q_next);
+
+        if (y[2]*y[2] + y[3]*y[3] > r_sq)
+        {
+            t_escape = i*h;
+            return escape_channel(y[2], y[3]);
+        }
+    }
+
+    t_escape = t_max;
+    return ESCAPE_TRAPPED;
+}
+
+//An orbit compiled for each instruction set (see dispatch.h)
+//Only the orbits are, the parallel loop over the grid is shared by all instruction sets
+HHP_MULTIVERSION(
+    escape_orbit, escape_orbit_impl,
+    (const Ref<const Array<double, 4, 1>> y0, const double& h, const double& t_max, double& t_escape),
+    (y0, h, t_max, t_escape),
+    int
+)
+
+/**
+ * @brief
+ * Compute the escape basins on a grid of the section q1 = 0 (see escape.h). The grid spans
+ * escape_q2 and escape_p2 (see constants.h), and p1 > 0 follows from the energy
+ *
+ * @param H_0 energy of the orbits, above 1/6 for the channels to be open
+ * @param h length of timestep
+ * @param t_max longest time to integrate an orbit
+ * @param n_q2 number of grid points in q2
+ * @param n_p2 number of grid points in p2
+ * @return EscapeResult the basin raster and escape times, with their statistics
+ */
+EscapeResult escape_basin(const double& H_0, const double& h, const double& t_max, const int& n_q2, const int& n_p2)
+{
+    EscapeResult R;
+    R.channel.resize(n_p2, n_q2);
+    R.time.resize(n_p2, n_q2);
+
+    const double dq2 = (escape_q2[1] - escape_q2[0]) / std::max(n_q2 - 1, 1);
+    const double dp2 = (escape_p2[1] - escape_p2[0]) / std::max(n_p2 - 1, 1);
+    const std::int64_t points = std::int64_t(n_q2)*n_p2;
+    std::int64_t steps = 0;
+
+    //The lifetimes range from a few time units to t_max, so the grid points are handed out
+    //in small chunks to whichever thread is done with its previous ones
+    #pragma omp parallel for schedule(dynamic, ESCAPE_CHUNK) reduction(+: steps)
+    for (std::int64_t k = 0; k < points; k++)
+    {
+        int i = int(k % n_p2);
+        int j = int(k / n_p2);
+        double q2 = escape_q2[0] + j*dq2;
+        double p2 = escape_p2[0] + i*dp2;
+
+        double p1_sq = 2*H_0 - p2*p2 - q2*q2 + 2.0/3.0*q2*q2*q2;
+        if (p1_sq < 0)
+        {
+            R.channel(i, j) = ESCAPE_FORBIDDEN;
+            R.time(i, j) = 0;
+            continue;
+        }
+
+        double t_escape;
+        R.channel(i, j) = escape_orbit(Array<double, 4, 1>(std::sqrt(p1_sq), p2, 0, q2), h, t_max, t_escape);
+        R.time(i, j) = t_escape;
+        steps += std::int64_t(std::ceil(t_escape/h - 0.5));
+    }
+    R.steps = steps;
+
+    //Statistics of each outcome, the trapped orbits are the last one
+    std::vector<double> escaped;
+    for (std::int64_t k = 0; k < points; k++)
+    {
+        int c = int(R.channel(k));
+        if (c == ESCAPE_FORBIDDEN)
+            continue;
+
+        int outcome = (c == ESCAPE_TRAPPED) ? 3 : c;
+        R.count[outcome]++;
+        R.mean_time[outcome] += R.time(k);
+        if (c != ESCAPE_TRAPPED)
+            escaped.push_back(R.time(k));
+    }
+    for (int outcome = 0; outcome < 4; outcome++)
+        if (R.count[outcome])
+            R.mean_time[outcome] /= R.count[outcome];
+
+    if (!escaped.empty())
+    {
+        std::nth_element(escaped.begin(), escaped.begin() + escaped.size()/2, escaped.end());
+        R.median_time = escaped[escaped.size()/2];
+    }
+
+    return R;
+}
+
+/**
+ * @brief
+ * Compute the escape basins, and save the raster of channels, the escape times and the
+ * statistics in files (see escape_basin_file, escape_time_file and escape_stats_file).
+ * A row of the statistics is: outcome (0, 1, 2 channel, -1 trapped), count, mean escape time,
+ * and the last row is the median escape time and the number of steps of all orbits
+ *
+ * @param H_0 energy of the orbits
+ * @param h length of timestep
+ * @param t_max longest time to integrate an orbit
+ * @param n_q2 number of grid points in q2
+ * @param n_p2 number of grid points in p2
+ */
+void compute_escape_basin(const double& H_0, const double& h, const double& t_max, const int& n_q2, const int& n_p2)
+{
+    EscapeResult R = escape_basin(H_0, h, t_max, n_q2, n_p2);
+
+    Matrix<double, 5, 3> stats;
+    for (int outcome = 0; outcome < 4; outcome++)
+        stats.row(outcome) << ((outcome < 3) ? outcome : ESCAPE_TRAPPED), double(R.count[outcome]), R.mean_time[outcome];
+    stats.row(4) << R.median_time, double(R.steps), 0;
+
+    matrix_to_CSV(escape_basin_file, R.channel.matrix());
+    matrix_to_CSV(escape_time_file, R.time.matrix());
+    matrix_to_CSV(escape_stats_file, stats);
+}
@@ -0,0 +1,36 @@
+#pragma once
+
+#include "poincare.h"
+
+//Escape basins of the Hénon Heiles system above the threshold energy H = 1/6
+//Above it the equipotential curve opens at the three saddles (0, 1) and (±sqrt(3)/2, -1/2),
+//and most orbits leave through one of the three channels. Every initial condition of a grid on the
+//section q1 = 0 (p1 > 0) is integrated with Störmer-Verlet until it leaves the circle of radius
+//ESCAPE_RADIUS, and the channel is the saddle nearest to the point where it left.
+//An orbit stops at its escape, so the cost follows the lifetimes of the orbits instead of t_max,
+//and the grid points are handed out to the threads dynamically since the lifetimes vary a lot
+
+//Radius of the circle an orbit has escaped when it leaves, well beyond the saddles at radius 1
+constexpr double ESCAPE_RADIUS = 2;
+
+//Number of grid points a thread takes at a time
+constexpr int ESCAPE_CHUNK = 16;
+
+//Values of the basin raster that are not a channel (0 upper, 1 lower left, 2 lower right)
+constexpr int ESCAPE_TRAPPED = -1;      //Did not escape before t_max
+constexpr int ESCAPE_FORBIDDEN = -2;    //Outside the energetically allowed region
+
+struct EscapeResult
+{
+    Array<double, Dynamic, Dynamic> channel;    //Exit channel of each grid point, rows p2 and columns q2
+    Array<double, Dynamic, Dynamic> time;       //Escape time of each grid point (t_max if trapped, 0 if forbidden)
+    std::int64_t count[4] = {0, 0, 0, 0};       //Number of orbits leaving through each channel, and trapped ones
+    double mean_time[4] = {0, 0, 0, 0};         //Their mean escape time
+    double median_time = 0;                     //Median escape time of the escaped orbits
+    std::int64_t steps = 0;                     //Number of steps of all orbits
+};
+
+int escape_channel(const double& q1, const double& q2);
+int escape_orbit(const Ref<const Array<double, 4, 1>> y0, const double& h, const double& t_max, double& t_escape);
+EscapeResult escape_basin(const double& H_0, const double& h, const double& t_max, const int& n_q2, const int& n_p2);
+void compute_escape_basin(const double& H_0, const double& h, const double& t_max, const int& n_q2, const int& n_p2);
@@ -0,0 +1,246 @@
+#include "frequency.h"
+
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+
+//Maximum number of Newton iterations refining a frequency
+constexpr int NAFF_MAX_ITERATIONS = 10;
+
+/**
+ * @brief
+ * Whether n is a positive power of two, the lengths the FFT works with
+ */
+static bool is_power_of_two(const std::int64_t& n)
+{
+    return n > 0 && !(n & (n - 1));
+}
+
+/**
+ * @brief
+ * In-place radix-2 fast Fourier transform, Z_k = sum_j z_j exp(-2 pi i j k/n)
+ *
+ * @param z the values, their number must be a power of two
+ */
+void fft(std::vector<std::complex<double>>& z)
+{
+    std::size_t n = z.size();
+    if (n && !is_power_of_two(std::int64_t(n)))
+        throw std::invalid_argument("fft: the number of values must be a power of two, not " + std::to_string(n));
+
+    //Bit reversal permutation
+    for (std::size_t i = 1, j = 0; i < n; i++)
+    {
+        std::size_t bit = n >> 1;
+        for (; j & bit; bit >>= 1)
+            j ^= bit;
+        j ^= bit;
+
+        if (i < j)
+            std::swap(z[i], z[j]);
+    }
+
+    //Butterflies, doubling the length of the transforms every pass
+    for (std::size_t len = 2; len <= n; len <<= 1)
+    {
+        std::complex<double> w_len = std::polar(1.0, -2*M_PI/len);
+        for (std::size_t i = 0; i < n; i += len)
+        {
+            std::complex<double> w = 1;
+            for (std::size_t k = 0; k < len/2; k++)
+            {
+                std::complex<double> u = z[i + k];
+                std::complex<double> v = z[i + k + len/2] * w;
+                z[i + k] = u + v;
+                z[i + k + len/2] = u - v;
+                w *= w_len;
+            }
+        }
+    }
+}
+
+/**
+ * @brief
+ * The fundamental frequency of a signal (NAFF), the frequency omega maximizing the
+ * amplitude of the Hann windowed Fourier integral |sum_j w_j z_j exp(-i omega t_j)|.
+ * The peak of the FFT gives the first guess, which is refined by interpolating the peak
+ * and then with Newton's method on the squared amplitude
+ *
+ * @param z the signal, sampled every dt (the number of samples must be a power of two)
+ * @param dt time between the samples
+ * @return double the (angular) frequency
+ */
+double naff_frequency(const std::vector<std::complex<double>>& z, const double& dt)
+{
+    int n = int(z.size());
+    if (!is_power_of_two(n))
+        throw std::invalid_argument("naff_frequency: the number of samples must be a positive power of two, not " + std::to_string(n));
+
+    //Hann window, the times are centered in the window so they stay small
+    std::vector<std::complex<double>> zw(n);
+    for (int j = 0; j < n; j++)
+        zw[j] = 0.5*(1 - std::cos(2*M_PI*j/n)) * z[j];
+
+    //Peak of the spectrum
+    std::vector<std::complex<double>> Z = zw;
+    fft(Z);
+    int k_max = 0;
+    for (int k = 1; k < n; k++)
+        if (std::norm(Z[k]) > std::norm(Z[k_max]))
+            k_max = k;
+
+    //Quadratic interpolation of the log amplitudes around the peak
+    double a = std::log(std::abs(Z[(k_max + n - 1) % n]) + 1e-300);
+    double b = std::log(std::abs(Z[k_max]) + 1e-300);
+    double c = std::log(std::abs(Z[(k_max + 1) % n]) + 1e-300);
+    double offset = (a - 2*b + c != 0) ? 0.5*(a - c)/(a - 2*b + c) : 0;
+
+    double bin = 2*M_PI/(n*dt);
+    double omega = ((k_max > n/2) ? k_max - n : k_max) * bin + offset * bin;
+
+    //Newton's method on A(omega) = |S|^2, with S = sum_j zw_j exp(-i omega t_j)
+    //and its derivatives S' and S'' computed in the same pass
+    for (int it = 0; it < NAFF_MAX_ITERATIONS; it++)
+    {
+        std::complex<double> S = 0, dS = 0, ddS = 0;
+        std::complex<double> rot = std::polar(1.0, -omega*dt);
+        std::complex<double> e = std::polar(1.0, omega*0.5*(n - 1)*dt);
+        for (int j = 0; j < n; j++)
+        {
+            double t = (j - 0.5*(n - 1))*dt;
+            std::complex<double> term = zw[j] * e;
+            S += term;
+            dS += std::complex<double>(0, -t) * term;
+            ddS += -t*t * term;
+            e *= rot;
+        }
+
+        double dA = 2*std::real(std::conj(S)*dS);
+        double ddA = 2*(std::norm(dS) + std::real(std::conj(S)*ddS));
+        if (ddA >= 0)
+            break;
+
+        //Never leave the peak of the first guess
+        double step = std::max(-0.5*bin, std::min(0.5*bin, -dA/ddA));
+        omega += step;
+        if (std::abs(step) <= 1e-15*std::abs(omega))
+            break;
+    }
+
+    return omega;
+}
+
+/**
+ * @brief
+ * Frequency analysis of a run, the run is integrated on the calling thread
+ * while a helper thread analyses the filled windows, so the integration is not slowed down
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @param window number of stored columns in each window (a power of two)
+ * @return FrequencyResult
+ */
+static FrequencyResult compute_frequency_impl(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const int& window)
+{
+    //Checked before the helper thread starts, which could not pass the error on
+    if (!is_power_of_two(window))
+        throw std::invalid_argument("compute_frequency: the window must be a positive power of two, not " + std::to_string(window));
+
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t m = std::get<1>(vals);
+    double dt = h*std::get<2>(vals);
+
+    //Only whole windows are analysed, and never the (possibly shorter) last step
+    std::int64_t n_windows = (m - 1) / window;
+
+    FrequencyResult result;
+    result.t.resize(n_windows);
+    result.nu1.resize(n_windows);
+    result.nu2.resize(n_windows);
+
+    //Filled windows waiting for the helper thread, (index, q1 - i p1, q2 - i p2)
+    struct Window
+    {
+        std::int64_t index;
+        std::vector<std::complex<double>> z1, z2;
+    };
+    std::deque<Window> queue;
+    std::mutex mutex;
+    std::condition_variable changed;
+    bool done = false;
+
+    std::thread helper([&]()
+    {
+        while (true)
+        {
+            Window w;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                changed.wait(lock, [&]() { return !queue.empty() || done; });
+                if (queue.empty())
+                    return;
+                w = std::move(queue.front());
+                queue.pop_front();
+            }
+            changed.notify_all();
+
+            result.t[w.index] = t_0 + w.index*window*dt;
+            result.nu1[w.index] = naff_frequency(w.z1, dt);
+            result.nu2[w.index] = naff_frequency(w.z2, dt);
+        }
+    });
+
+    Window current{0, std::vector<std::complex<double>>(window), std::vector<std::complex<double>>(window)};
+    stream_method(method, t_0, t_end, y0, h,
+        [&](const std::int64_t& j, const Ref<const Array<double, 4, 1>> y)
+        {
+            if (j >= n_windows*window)
+                return;
+
+            int c = int(j % window);
+            current.z1[c] = std::complex<double>(y[2], -y[0]);
+            current.z2[c] = std::complex<double>(y[3], -y[1]);
+            if (c < window - 1)
+                return;
+
+            //Hand the full window to the helper thread, waiting if it is too far behind
+            std::unique_lock<std::mutex> lock(mutex);
+            changed.wait(lock, [&]() { return int(queue.size()) < FREQUENCY_QUEUE; });
+            queue.push_back(std::move(current));
+            lock.unlock();
+            changed.notify_all();
+
+            current = Window{j / window + 1, std::vector<std::complex<double>>(window), std::vector<std::complex<double>>(window)};
+        });
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        done = true;
+    }
+    changed.notify_all();
+    helper.join();
+
+    //Frequency diffusion between successive windows
+    for (std::int64_t k = 1; k < n_windows; k++)
+    {
+        double d1 = std::abs(result.nu1[k] - result.nu1[k-1]) / std::abs(result.nu1[k-1]);
+        double d2 = std::abs(result.nu2[k] - result.nu2[k-1]) / std::abs(result.nu2[k-1]);
+        result.diffusion.push_back(std::log10(std::max(d1, d2)));
+        result.max_diffusion = std::max(result.max_diffusion, result.diffusion.back());
+    }
+
+    return result;
+}
+
+//The frequency analysis compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    compute_frequency, compute_frequency_impl,
+    (const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const int& window),
+    (method, t_0, t_end, y0, h, window),
+    FrequencyResult
+)
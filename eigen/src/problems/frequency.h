@@ -0,0 +1,31 @@
+#pragma once
+
+#include <complex>
+#include <vector>
+
+#include "streaming.h"
+
+//Frequency analysis (NAFF) of a run while it is computed, to tell regular orbits from chaotic ones
+//The run is cut into windows of stored columns, and the fundamental frequency of
+//q1 - i p1 and q2 - i p2 is found in every window: the peak of the FFT of the Hann windowed
+//signal, refined by maximizing the windowed Fourier integral around it (Laskar's NAFF).
+//Regular orbits keep their frequencies, while the frequencies of chaotic orbits diffuse
+
+//Default number of stored columns in a window, a power of two for the FFT
+constexpr int FREQUENCY_WINDOW = 4096;
+
+//Number of filled windows that may wait for the helper thread before the integration waits for it
+constexpr int FREQUENCY_QUEUE = 4;
+
+struct FrequencyResult
+{
+    std::vector<double> t;              //Start time of each window
+    std::vector<double> nu1;            //Fundamental (angular) frequency of q1 - i p1 in each window
+    std::vector<double> nu2;            //Fundamental (angular) frequency of q2 - i p2 in each window
+    std::vector<double> diffusion;      //log10 of the largest relative frequency change from the previous window
+    double max_diffusion = -INFINITY;   //Largest of them, values near machine precision mean a regular orbit
+};
+
+void fft(std::vector<std::complex<double>>& z);
+double naff_frequency(const std::vector<std::complex<double>>& z, const double& dt);
+FrequencyResult compute_frequency(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, const int& window = FREQUENCY_WINDOW);
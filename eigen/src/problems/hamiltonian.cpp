@@ -1,5 +1,86 @@
 #include "hamiltonian.h"
 
+#include <algorithm>
+#include <omp.h>
+
+/**
+ * @brief Run block(begin, end) over the columns [0, cols) in blocks of HAMILTONIAN_BLOCK columns,
+ * in parallel. Outside a parallel region the blocks are handed out with a static schedule, the one
+ * first_touch placed the pages with, so each thread reads the pages on its own NUMA node. Inside a
+ * parallel region (e.g. a task of compute_both) the blocks are tasks of that region, so threads
+ * that are done with their own work pick them up (wherever the pages are)
+ * 
+ * @param cols number of columns
+ * @param block Computes the columns [begin, end)
+ */
+template <typename Block>
+static void for_blocks(const std::int64_t& cols, Block block)
+{
+    std::int64_t n_blocks = (cols + HAMILTONIAN_BLOCK - 1) / HAMILTONIAN_BLOCK;
+    if (n_blocks <= 1)
+    {
+        block(0, cols);
+        return;
+    }
+
+    if (omp_in_parallel())
+    {
+        #pragma omp taskloop grainsize(1)
+        for (std::int64_t b = 0; b < n_blocks; b++)
+            block(b*HAMILTONIAN_BLOCK, std::min(cols, (b + 1)*HAMILTONIAN_BLOCK));
+    }
+    else
+    {
+        #pragma omp parallel for schedule(static)
+        for (std::int64_t b = 0; b < n_blocks; b++)
+            block(b*HAMILTONIAN_BLOCK, std::min(cols, (b + 1)*HAMILTONIAN_BLOCK));
+    }
+}
+
+/**
+ * @brief The hamiltonian for this Hénon Heiles system of a block of columns, written into H
+ * 
+ * @param Y The columns of the computed matrix
+ * @param H The hamiltonian, with one value for each column of Y
+ */
+static void hamiltonian_block_impl(const Ref<const Matrix<double, 4, Dynamic>> Y, Ref<Array<double, Dynamic, 1>> H)
+{
+    const double* y = Y.data();
+    const std::int64_t stride = Y.outerStride();
+    double* out = H.data();
+
+    #pragma omp simd
+    for (std::int64_t j = 0; j < Y.cols(); j++)
+    {
+        const double* c = y + stride*j;
+        out[j] = potential_energy(HenonHeiles(), c[0], c[1], c[2], c[3]);
+    }
+}
+
+//A block of the hamiltonian compiled for each instruction set (see dispatch.h)
+//Only the blocks are, the parallel loop over them is shared by all instruction sets
+HHP_MULTIVERSION(
+    hamiltonian_block, hamiltonian_block_impl,
+    (const Ref<const Matrix<double, 4, Dynamic>> Y, Ref<Array<double, Dynamic, 1>> H),
+    (Y, H),
+    void
+)
+
+/**
+ * @brief The hamiltonian for this Hénon Heiles system, written into H
+ * 
+ * @param Y The computed matrix
+ * @param H The hamiltonian, with one value for each column of Y
+ */
+void hamiltonian(const Ref<const Matrix<double, 4, Dynamic>> Y, Ref<Array<double, Dynamic, 1>> H)
+{
+    for_blocks(Y.cols(), 
+        [&](const std::int64_t& begin, const std::int64_t& end)
+        {
+            hamiltonian_block(Y.middleCols(begin, end - begin), H.segment(begin, end - begin));
+        });
+}
+
 /**
  * @brief The hamiltonian for this Hénon Heiles system
  * 
@@ -8,7 +89,89 @@
  */
 Array<double, Dynamic, 1> hamiltonian(const Ref<const Matrix<double, 4, Dynamic>> Y)
 {
-    return 0.5 * (Y.row(0).array().square() + Y.row(1).array().square())
-        +  0.5 * (Y.row(2).array().square() + Y.row(3).array().square())
-        +  Y.row(3).array() * Y.row(2).array().square() - 1.0/3.0 * Y.row(3).array().cube();
-}
\ No newline at end of file
+    Array<double, Dynamic, 1> H(Y.cols());
+    advise_storage(H.data(), H.size()*sizeof(double));
+    hamiltonian(Y, H);
+
+    return H;
+}
+
+/**
+ * @brief The hamiltonian of a compressed matrix, decompressed one block at a time
+ * 
+ * @param C The compressed matrix
+ * @return vec The hamiltonian as a column vector
+ */
+Array<double, Dynamic, 1> hamiltonian(const CompressedTrajectory& C)
+{
+    Array<double, Dynamic, 1> H(compressed_cols(C));
+    Matrix<double, 4, Dynamic> block(4, COMPRESSED_BLOCK);
+
+    for (int b = 0; b < compressed_blocks(C); b++)
+    {
+        int cols = decompress_block(C, b, block);
+        hamiltonian(block.leftCols(cols), H.segment(C.starts[b], cols));
+    }
+
+    return H;
+}
+
+/**
+ * @brief The hamiltonian of the columns [begin, end) of a structure-of-arrays trajectory,
+ * written into H. One fused pass that reads each component with unit stride
+ * 
+ * @param T The computed trajectory
+ * @param begin First column, a multiple of HAMILTONIAN_BLOCK so the components stay aligned
+ * @param end End of the columns
+ * @param H The hamiltonian, with one value for each column of T
+ */
+static void hamiltonian_trajectory_block_impl(const Trajectory& T, const std::int64_t& begin, const std::int64_t& end, Ref<Array<double, Dynamic, 1>> H)
+{
+    const double* p1 = trajectory_data(T, 0) + begin;
+    const double* p2 = trajectory_data(T, 1) + begin;
+    const double* q1 = trajectory_data(T, 2) + begin;
+    const double* q2 = trajectory_data(T, 3) + begin;
+    double* out = H.data() + begin;
+
+    #pragma omp simd aligned(p1, p2, q1, q2 : TRAJECTORY_ALIGN)
+    for (std::int64_t j = 0; j < end - begin; j++)
+        out[j] = potential_energy(HenonHeiles(), p1[j], p2[j], q1[j], q2[j]);
+}
+
+//A block of the hamiltonian of a trajectory compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    hamiltonian_trajectory_block, hamiltonian_trajectory_block_impl,
+    (const Trajectory& T, const std::int64_t& begin, const std::int64_t& end, Ref<Array<double, Dynamic, 1>> H),
+    (T, begin, end, H),
+    void
+)
+
+/**
+ * @brief The hamiltonian of a structure-of-arrays trajectory, written into H
+ * 
+ * @param T The computed trajectory
+ * @param H The hamiltonian, with one value for each column of T
+ */
+void hamiltonian(const Trajectory& T, Ref<Array<double, Dynamic, 1>> H)
+{
+    for_blocks(T.cols, 
+        [&](const std::int64_t& begin, const std::int64_t& end)
+        {
+            hamiltonian_trajectory_block(T, begin, end, H);
+        });
+}
+
+/**
+ * @brief The hamiltonian of a structure-of-arrays trajectory
+ * 
+ * @param T The computed trajectory
+ * @return vec The hamiltonian as a column vector
+ */
+Array<double, Dynamic, 1> hamiltonian(const Trajectory& T)
+{
+    Array<double, Dynamic, 1> H(T.cols);
+    advise_storage(H.data(), H.size()*sizeof(double));
+    hamiltonian(T, H);
+
+    return H;
+}
@@ -1,10 +1,41 @@
 #pragma once
 
+#include "../compressed.h"
+#include "../trajectory.h"
 // #include "../methods/kahans.h"
 #include "../methods/rk4.h"
 // #include "../methods/sb.h"
 // #include "../methods/sv.h"
 
 //Compute the hamiltonian of a Hénon Heiles system
+//The columns are split into blocks of HAMILTONIAN_BLOCK columns that are computed in parallel,
+//and the versions taking H write into it (e.g. a column of a larger matrix) instead of returning a new array
 
-Array<double, Dynamic, 1> hamiltonian(const Ref<const Matrix<double, 4, Dynamic>> Y);
\ No newline at end of file
+//Number of columns in each parallel block (128 KiB of a matrix, so a block stays in the L2 cache),
+//the blocks first_touch places the pages of a run with (see memory.h)
+constexpr std::int64_t HAMILTONIAN_BLOCK = PARALLEL_BLOCK;
+
+Array<double, Dynamic, 1> hamiltonian(const Ref<const Matrix<double, 4, Dynamic>> Y);
+void hamiltonian(const Ref<const Matrix<double, 4, Dynamic>> Y, Ref<Array<double, Dynamic, 1>> H);
+Array<double, Dynamic, 1> hamiltonian(const CompressedTrajectory& C);
+Array<double, Dynamic, 1> hamiltonian(const Trajectory& T);
+void hamiltonian(const Trajectory& T, Ref<Array<double, Dynamic, 1>> H);
+
+/**
+ * @brief The hamiltonian of a system with any potential (see potentials.h)
+ * 
+ * @param V the potential
+ * @param Y The computed matrix
+ * @return vec The hamiltonian as a column vector
+ */
+template <typename Potential>
+    //Only for potentials, so hamiltonian(Y, H) never picks this overload
+    requires requires (const Potential& V, const double& q) { V.U(q, q); }
+Array<double, Dynamic, 1> hamiltonian(const Potential& V, const Ref<const Matrix<double, 4, Dynamic>> Y)
+{
+    Array<double, Dynamic, 1> q1 = Y.row(2).transpose().array();
+    Array<double, Dynamic, 1> q2 = Y.row(3).transpose().array();
+
+    return 0.5 * (Y.row(0).array().square() + Y.row(1).array().square()).transpose()
+        +  V.U(q1, q2);
+}
\ No newline at end of file
@@ -0,0 +1,328 @@
+#include "pipeline.h"
+
+#include <exception>
+#include <thread>
+
+/**
+ * @brief
+ * Wait until ready() is true, spinning PIPELINE_SPIN times before sleeping until the other side
+ * wakes it (see ring_wake), so a side waiting for the other does not hold on to its core
+ *
+ * @param R the ring
+ * @param ready Checks the other side of the ring, ready()
+ */
+template <typename Ready>
+static void ring_wait(StateRing& R, Ready ready)
+{
+    for (int i = 0; i < PIPELINE_SPIN; i++)
+        if (ready())
+            return;
+
+    //The fence pairs with the one in ring_wake: either the other side sees the sleeper and wakes it,
+    //or ready() sees the counter the other side just moved. The lock is held until wait() sleeps,
+    //so the wake cannot come in between
+    std::unique_lock<std::mutex> lock(R.mutex);
+    R.sleepers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    R.wake.wait(lock, ready);
+    R.sleepers.fetch_sub(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief
+ * Wake the other side of the ring after moving a counter, if it sleeps in ring_wait
+ *
+ * @param R the ring
+ */
+static void ring_wake(StateRing& R)
+{
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if (R.sleepers.load(std::memory_order_relaxed) > 0)
+    {
+        std::lock_guard<std::mutex> lock(R.mutex);
+        R.wake.notify_all();
+    }
+}
+
+/**
+ * @brief
+ * Allocate the blocks of an empty ring
+ *
+ * @param R the ring
+ */
+void create_ring(StateRing& R)
+{
+    R.blocks.resize(PIPELINE_RING);
+    for (StateBlock& block : R.blocks)
+        block.Y = create_Y(PIPELINE_BLOCK + 1);
+
+    R.head.store(0);
+    R.tail.store(0);
+    R.closed.store(false);
+    R.sleepers.store(0);
+}
+
+/**
+ * @brief
+ * The block the producer fills next, once the consumer is done with it
+ *
+ * @param R the ring
+ * @return StateBlock& the block
+ */
+StateBlock& ring_next_free(StateRing& R)
+{
+    std::int64_t head = R.head.load(std::memory_order_relaxed);
+    ring_wait(R, [&]() { return head - R.tail.load(std::memory_order_acquire) < PIPELINE_RING; });
+
+    return R.blocks[head % PIPELINE_RING];
+}
+
+/**
+ * @brief
+ * Hand the block from ring_next_free to the consumer
+ *
+ * @param R the ring
+ */
+void ring_publish(StateRing& R)
+{
+    R.head.store(R.head.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ring_wake(R);
+}
+
+/**
+ * @brief
+ * Tell the consumer that no more blocks will be published
+ *
+ * @param R the ring
+ */
+void ring_close(StateRing& R)
+{
+    R.closed.store(true, std::memory_order_release);
+    ring_wake(R);
+}
+
+/**
+ * @brief
+ * The block the consumer analyses next, once the producer has published it
+ *
+ * @param R the ring
+ * @return StateBlock* the block, nullptr once the ring is closed and every block is analysed
+ */
+StateBlock* ring_next_full(StateRing& R)
+{
+    std::int64_t tail = R.tail.load(std::memory_order_relaxed);
+    bool closed = false;
+    ring_wait(R, [&]()
+    {
+        //closed is read first, so a block published before the ring was closed is never missed
+        closed = R.closed.load(std::memory_order_acquire);
+        return closed || R.head.load(std::memory_order_acquire) > tail;
+    });
+
+    if (R.head.load(std::memory_order_acquire) > tail)
+        return &R.blocks[tail % PIPELINE_RING];
+
+    return nullptr;
+}
+
+/**
+ * @brief
+ * Hand the block from ring_next_full back to the producer
+ *
+ * @param R the ring
+ */
+void ring_release(StateRing& R)
+{
+    R.tail.store(R.tail.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+    ring_wake(R);
+}
+
+/**
+ * @brief
+ * Integrate with one of the methods chosen by name, and publish the columns it would store
+ * to the ring, one block at a time
+ *
+ * @param R the ring (closed by the caller, also when this throws)
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ */
+static void pipeline_produce_impl(StateRing& R, const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    StateBlock* block = &ring_next_free(R);
+    block->first = 0;
+    block->cols = 0;
+
+    stream_method(method, t_0, t_end, y0, h,
+        [&](const std::int64_t& j, const Ref<const Array<double, 4, 1>> y)
+        {
+            block->cols++;
+            block->Y.col(block->cols) = y;
+
+            if (block->cols == PIPELINE_BLOCK)
+            {
+                ring_publish(R);
+                StateBlock* next = &ring_next_free(R);
+                next->Y.col(0) = y;
+                next->first = j + 1;
+                next->cols = 0;
+                block = next;
+            }
+        });
+
+    if (block->cols)
+        ring_publish(R);
+}
+
+//The producer of the pipeline compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    pipeline_produce, pipeline_produce_impl,
+    (StateRing& R, const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (R, method, t_0, t_end, y0, h),
+    void
+)
+
+/**
+ * @brief
+ * Analyse the blocks of the ring until it is closed: the hamiltonian of each column,
+ * and the Poincaré map (the same as hamiltonian() and poincare() on the whole run).
+ * If the analysis throws, the remaining blocks are still released, so the producer never waits forever
+ *
+ * @param R the ring
+ * @param H the hamiltonian, one value for each column of the run
+ * @param P the Poincaré map
+ * @param error the exception thrown by the analysis, if any
+ */
+static void pipeline_consume(StateRing& R, Ref<Array<double, Dynamic, 1>> H, Matrix<double, 2, Dynamic>& P, std::exception_ptr& error)
+{
+    //Section points, stored as (q2, p2) pairs
+    std::vector<double> points;
+
+    while (StateBlock* block = ring_next_full(R))
+    {
+        if (!error)
+        {
+            try
+            {
+                hamiltonian(block->Y.middleCols(1, block->cols), H.segment(block->first, block->cols));
+
+                //The first column holds the last column of the previous block,
+                //so crossings between two blocks are found too
+                int first = block->first ? 0 : 1;
+                Matrix<double, 2, Dynamic> P_block = poincare(block->Y.middleCols(first, block->cols + 1 - first));
+                points.insert(points.end(), P_block.data(), P_block.data() + P_block.size());
+            }
+            catch (...)
+            {
+                error = std::current_exception();
+            }
+        }
+
+        ring_release(R);
+    }
+
+    if (!error)
+        P = Eigen::Map<Matrix<double, 2, Dynamic>>(points.data(), 2, points.size()/2);
+}
+
+/**
+ * @brief
+ * Compute the hamiltonian and Poincaré map of a method while it integrates, on a
+ * dedicated consumer thread (see pipeline.h). The method runs on the calling thread.
+ * The ring is closed and the consumer joined whether the method finishes or throws,
+ * and an exception of either side is rethrown afterwards
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @param H the hamiltonian, one value for each column the method would store (see create_T)
+ * @param P the Poincaré map
+ */
+void pipeline_method(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, Ref<Array<double, Dynamic, 1>> H, Matrix<double, 2, Dynamic>& P)
+{
+    //An unknown method would only throw after the consumer started
+    if (method != "rk4" && method != "sb" && method != "kahans" && method != "sv")
+        throw std::invalid_argument("pipeline_method: unknown method " + method);
+
+    StateRing R;
+    create_ring(R);
+
+    std::exception_ptr produce_error, consume_error;
+    std::thread consumer([&]() { pipeline_consume(R, H, P, consume_error); });
+
+    try
+    {
+        pipeline_produce(R, method, t_0, t_end, y0, h);
+    }
+    catch (...)
+    {
+        produce_error = std::current_exception();
+    }
+
+    ring_close(R);
+    consumer.join();
+
+    if (produce_error)
+        std::rethrow_exception(produce_error);
+    if (consume_error)
+        std::rethrow_exception(consume_error);
+}
+
+/**
+ * @brief
+ * Compute the hamiltonians and Poincaré maps of all the implemented methods,
+ * like compute_both, but analyse each run while it is computed instead of storing it
+ *
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition for system
+ * @param h length of timestep
+ */
+void compute_pipelined(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    Matrix<double, 2, Dynamic> P_rk, P_sb, P_kahans, P_sv;
+
+    //Time array
+    Array<double, Dynamic, 1> T = create_T(t_0, t_end, h);
+
+    //Matrix containing the time in the first column and hamiltonians of all methods in the second
+    //Should have n rows (number of time steps) and the number of methods + 1 columns
+    Matrix<double, Dynamic, 5> H(T.size(), 5);
+
+    //Add the time vector to our matrix
+    H.col(0) = T;
+
+    //Each method integrates in a task, and its consumer thread analyses it alongside
+    #pragma omp parallel
+    {
+        #pragma omp single nowait
+        {
+            #pragma omp task
+            pipeline_method("rk4", t_0, t_end, y0, h, H.col(1).array(), P_rk);
+
+            #pragma omp task
+            pipeline_method("sb", t_0, t_end, y0, h, H.col(2).array(), P_sb);
+
+            #pragma omp task
+            pipeline_method("kahans", t_0, t_end, y0, h, H.col(3).array(), P_kahans);
+
+            #pragma omp task
+            pipeline_method("sv", t_0, t_end, y0, h, H.col(4).array(), P_sv);
+        }
+    }
+
+    //Uncomment the line(s) below if you actaully want the output
+    // matrix_to_CSV(hamiltonians_file + decimal_to_string(h), H);
+
+    // matrix_to_CSV(poincare_file_rk4 + decimal_to_string(h), P_rk);
+
+    // matrix_to_CSV(poincare_file_sb + decimal_to_string(h), P_sb);
+
+    // matrix_to_CSV(poincare_file_kahans + decimal_to_string(h), P_kahans);
+
+    // matrix_to_CSV(poincare_file_sv + decimal_to_string(h), P_sv);
+}
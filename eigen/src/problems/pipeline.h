@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+
+#include "hamiltonian.h"
+#include "streaming.h"
+
+//Integration and analysis at the same time, without storing the run
+//Each integrator hands the columns it would store to a ring of blocks of PIPELINE_BLOCK columns, and a
+//dedicated consumer thread computes the hamiltonian and Poincaré map of each block as soon as it is
+//full, while it is still in the (shared) cache. The ring has a single producer and a single consumer,
+//so the counters need no locks: each side only writes its own counter (on its own cache line). A side
+//that finds the ring full or empty spins for a while, then sleeps on a condition variable until the
+//other side moves its counter (which only takes the lock when a side sleeps). Only the hamiltonian
+//(one value per column) and the Poincaré map are kept, the trajectory never exists as a whole
+
+//Number of columns in each block (32 KiB, so a block is still in the cache when it is analysed)
+constexpr std::int64_t PIPELINE_BLOCK = 1024;
+
+//Number of blocks in each ring, so the integrator may run this far ahead of the analysis
+constexpr std::int64_t PIPELINE_RING = 16;
+
+//Number of times a side of the ring checks the other before it sleeps (about a microsecond, a small
+//part of the time to fill or analyse a block, so a side only sleeps when the other is much slower)
+constexpr int PIPELINE_SPIN = 1024;
+
+struct StateBlock
+{
+    Matrix<double, 4, Dynamic> Y;   //The last column of the previous block, followed by PIPELINE_BLOCK columns
+    std::int64_t first = 0;         //Index in the run of the first column after the previous one
+    std::int64_t cols = 0;          //Number of columns filled after the previous one
+};
+
+struct StateRing
+{
+    std::vector<StateBlock> blocks;
+
+    alignas(64) std::atomic<std::int64_t> head{0};  //Blocks published, written by the producer
+    alignas(64) std::atomic<std::int64_t> tail{0};  //Blocks analysed, written by the consumer
+    std::atomic<bool> closed{false};                //Set by the producer after its last block
+
+    //A side that waited PIPELINE_SPIN checks sleeps on wake, and counts itself in sleepers
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::atomic<int> sleepers{0};
+};
+
+void create_ring(StateRing& R);
+StateBlock& ring_next_free(StateRing& R);
+void ring_publish(StateRing& R);
+void ring_close(StateRing& R);
+StateBlock* ring_next_full(StateRing& R);
+void ring_release(StateRing& R);
+
+void pipeline_method(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, Ref<Array<double, Dynamic, 1>> H, Matrix<double, 2, Dynamic>& P);
+void compute_pipelined(const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
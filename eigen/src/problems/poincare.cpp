@@ -7,12 +7,12 @@
  * @param Y matrix as a result of an implemented method
  * @return mat the created Poincaré map
  */
-Matrix<double, 2, Dynamic> poincare(const Ref<const Matrix<double, 4, Dynamic>> Y)
+static Matrix<double, 2, Dynamic> poincare_impl(const Ref<const Matrix<double, 4, Dynamic>> Y)
 {
     // First count how many times this occurs, instead of using the time-consuming resize function
     // and to not use unessecary memory by creating an array with "maximum theoretical length"
-    int n = 0;
-    for (int i = 1; i < Y.cols(); i++)
+    std::int64_t n = 0;
+    for (std::int64_t i = 1; i < Y.cols(); i++)
     {
         if (Y.col(i)[0] > 0 && Y.col(i)[2] * Y.col(i-1)[2] < 0)
             n++;
@@ -20,10 +20,10 @@ Matrix<double, 2, Dynamic> poincare(const Ref<const Matrix<double, 4, Dynamic>>
 
 
     // Then perform the actual interpolation, to compute the desired points
-    Matrix<double, 2, Dynamic> p_mat = Matrix<double, 2, Dynamic>::Zero(2, n);
+    Matrix<double, 2, Dynamic> p_mat(2, n);
     n = 0;
     double lam = 0;
-    for (int i = 1; i < Y.cols(); i++)
+    for (std::int64_t i = 1; i < Y.cols(); i++)
     {
         if (Y.col(i)[0] > 0 && Y.col(i)[2] * Y.col(i-1)[2] < 0)
         {
@@ -35,4 +35,255 @@ Matrix<double, 2, Dynamic> poincare(const Ref<const Matrix<double, 4, Dynamic>>
     }
 
     return p_mat;
-}
\ No newline at end of file
+}
+
+//The Poincaré map compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    poincare, poincare_impl,
+    (const Ref<const Matrix<double, 4, Dynamic>> Y),
+    (Y),
+    Matrix<double, 2, Dynamic>
+)
+
+/**
+ * @brief 
+ * Compute the Poincaré map of a compressed matrix, decompressed one block at a time
+ * 
+ * @param C the compressed matrix
+ * @return mat the created Poincaré map
+ */
+Matrix<double, 2, Dynamic> poincare(const CompressedTrajectory& C)
+{
+    //The first column holds the last column of the previous block,
+    //so crossings between two blocks are found too
+    Matrix<double, 4, Dynamic> block(4, COMPRESSED_BLOCK + 1);
+    std::vector<Matrix<double, 2, Dynamic>> maps;
+    std::int64_t n = 0;
+
+    for (int b = 0; b < compressed_blocks(C); b++)
+    {
+        int first = b ? 0 : 1;
+        int cols = decompress_block(C, b, block.rightCols(COMPRESSED_BLOCK));
+
+        maps.push_back(poincare(block.middleCols(first, cols + 1 - first)));
+        n += maps.back().cols();
+
+        block.col(0) = block.col(cols);
+    }
+
+    Matrix<double, 2, Dynamic> p_mat(2, n);
+    n = 0;
+    for (const Matrix<double, 2, Dynamic>& map : maps)
+    {
+        p_mat.middleCols(n, map.cols()) = map;
+        n += map.cols();
+    }
+
+    return p_mat;
+}
+
+/**
+ * @brief 
+ * Compute the Poincaré map of a structure-of-arrays trajectory.
+ * The crossings are counted in a vectorized pass over the components,
+ * and only the (few) crossings are visited to interpolate
+ * 
+ * @param T the computed trajectory
+ * @return mat the created Poincaré map
+ */
+static Matrix<double, 2, Dynamic> poincare_trajectory_impl(const Trajectory& T)
+{
+    const double* p1 = trajectory_data(T, 0);
+    const double* p2 = trajectory_data(T, 1);
+    const double* q1 = trajectory_data(T, 2);
+    const double* q2 = trajectory_data(T, 3);
+
+    std::int64_t n = 0;
+    #pragma omp simd reduction(+:n)
+    for (std::int64_t i = 1; i < T.cols; i++)
+        n += (p1[i] > 0) & (q1[i] * q1[i-1] < 0);
+
+    Matrix<double, 2, Dynamic> p_mat(2, n);
+    n = 0;
+    double lam = 0;
+    for (std::int64_t i = 1; i < T.cols; i++)
+    {
+        if (p1[i] > 0 && q1[i] * q1[i-1] < 0)
+        {
+            lam = q1[i-1]/(q1[i-1] - q1[i]);
+            p_mat.col(n)[0] = lam * q2[i] + (1 - lam) * q2[i-1];
+            p_mat.col(n)[1] = lam * p2[i] + (1 - lam) * p2[i-1];
+            n++;
+        }
+    }
+
+    return p_mat;
+}
+
+//The Poincaré map of a trajectory compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    poincare, poincare_trajectory_impl,
+    (const Trajectory& T),
+    (T),
+    Matrix<double, 2, Dynamic>
+)
+/**
+ * @brief
+ * Create the section normal·y = offset (see poincare_sections),
+ * e.g. normal = (0, 0, 0, 1) and offset = 0 for the section q2 = 0
+ *
+ * @param normal weights of p1, p2, q1, q2
+ * @param offset value of normal·y on the section
+ * @param direction SECTION_UP, SECTION_DOWN or SECTION_BOTH
+ * @return Section
+ */
+Section create_section(const Ref<const Array<double, 4, 1>> normal, const double& offset, const int& direction)
+{
+    Section s;
+    s.normal = normal;
+    s.offset = offset;
+    s.direction = direction;
+
+    return s;
+}
+
+/**
+ * @brief
+ * Create the section H(y) = level (see poincare_sections), crossed upwards when the energy grows
+ *
+ * @param level energy of the section
+ * @param direction SECTION_UP, SECTION_DOWN or SECTION_BOTH
+ * @return Section
+ */
+Section create_energy_section(const double& level, const int& direction)
+{
+    Section s;
+    s.energy = 1;
+    s.offset = level;
+    s.direction = direction;
+
+    return s;
+}
+
+/**
+ * @brief
+ * Find the crossings of any number of sections in one pass over a matrix Y (see poincare.h)
+ *
+ * @param Y matrix as a result of an implemented method
+ * @param sections the sections
+ * @return one matrix for each section, with a column for each crossing: the interpolated
+ *         p1, p2, q1, q2 and the (fractional) column of Y it lies at, e.g. time t_0 + column*h*SKIP_STORAGE
+ */
+static std::vector<Matrix<double, 5, Dynamic>> poincare_sections_impl(const Ref<const Matrix<double, 4, Dynamic>> Y, const std::vector<Section>& sections)
+{
+    const std::int64_t n_sections = std::int64_t(sections.size());
+    const double* y = Y.data();
+    const std::int64_t stride = Y.outerStride();
+
+    bool with_energy = false;
+    for (const Section& s : sections)
+        with_energy |= (s.energy != 0);
+
+    //g of each section for the columns of a block, one row per section. The first value of a row
+    //holds the last value of the previous block, so crossings between two blocks are found too
+    std::vector<double> G(n_sections*(SECTION_BLOCK + 1));
+    std::vector<double> E(SECTION_BLOCK);
+
+    //Positions in a row of G of the crossings in a block
+    std::vector<std::int64_t> crossings(SECTION_BLOCK + 1);
+
+    //The crossings of each section as columns of 5 values, while their number is unknown
+    std::vector<std::vector<double>> points(n_sections);
+
+    for (std::int64_t b0 = 0; b0 < Y.cols(); b0 += SECTION_BLOCK)
+    {
+        const std::int64_t cols = std::min(SECTION_BLOCK, Y.cols() - b0);
+        const double* yb = y + stride*b0;
+
+        //Same energy as hamiltonian()
+        if (with_energy)
+        {
+            double* e = E.data();
+            #pragma omp simd
+            for (std::int64_t j = 0; j < cols; j++)
+            {
+                const double* c = yb + stride*j;
+                e[j] = potential_energy(HenonHeiles(), c[0], c[1], c[2], c[3]);
+            }
+        }
+
+        for (std::int64_t k = 0; k < n_sections; k++)
+        {
+            const Section& s = sections[k];
+            const double n0 = s.normal[0], n1 = s.normal[1], n2 = s.normal[2], n3 = s.normal[3];
+            const double w = s.energy, offset = s.offset, dir = s.direction;
+            const double* e = E.data();
+            double* g = G.data() + k*(SECTION_BLOCK + 1);
+
+            if (b0)
+                g[0] = g[SECTION_BLOCK];
+
+            if (with_energy)
+            {
+                #pragma omp simd
+                for (std::int64_t j = 0; j < cols; j++)
+                {
+                    const double* c = yb + stride*j;
+                    g[j + 1] = n0*c[0] + n1*c[1] + n2*c[2] + n3*c[3] + w*e[j] - offset;
+                }
+            }
+            else
+            {
+                #pragma omp simd
+                for (std::int64_t j = 0; j < cols; j++)
+                {
+                    const double* c = yb + stride*j;
+                    g[j + 1] = n0*c[0] + n1*c[1] + n2*c[2] + n3*c[3] - offset;
+                }
+            }
+
+            //A crossing is a sign change in the chosen direction: dir*g >= 0 after it
+            //(always true for SECTION_BOTH). The first column of Y has nothing before it.
+            //The index is written for every column and only kept for a crossing, so the loop has
+            //no branches, whether a block has crossings in it or not
+            const std::int64_t first = b0 ? 1 : 2;
+            std::int64_t n = 0;
+            for (std::int64_t j = first; j <= cols; j++)
+            {
+                crossings[n] = j;
+                n += (g[j - 1]*g[j] < 0) & (dir*g[j] >= 0);
+            }
+
+            std::size_t size = points[k].size();
+            points[k].resize(size + 5*n);
+            double* p = points[k].data() + size;
+            for (std::int64_t m = 0; m < n; m++, p += 5)
+            {
+                //Columns i - 1 and i of Y
+                std::int64_t j = crossings[m];
+                std::int64_t i = b0 + j - 1;
+                const double* c_prev = y + stride*(i - 1);
+                const double* c = y + stride*i;
+                double lam = g[j - 1]/(g[j - 1] - g[j]);
+
+                for (int r = 0; r < 4; r++)
+                    p[r] = lam * c[r] + (1 - lam) * c_prev[r];
+                p[4] = double(i - 1) + lam;
+            }
+        }
+    }
+
+    std::vector<Matrix<double, 5, Dynamic>> P(n_sections);
+    for (std::int64_t k = 0; k < n_sections; k++)
+        P[k] = Eigen::Map<const Matrix<double, 5, Dynamic>>(points[k].data(), 5, std::int64_t(points[k].size()) / 5);
+
+    return P;
+}
+
+//The crossings of several sections compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    poincare_sections, poincare_sections_impl,
+    (const Ref<const Matrix<double, 4, Dynamic>> Y, const std::vector<Section>& sections),
+    (Y, sections),
+    std::vector<Matrix<double, 5, Dynamic>>
+)
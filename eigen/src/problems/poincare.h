@@ -1,10 +1,43 @@
 #pragma once
 
+#include "../methods/gauss.h"
 #include "../methods/kahans.h"
 #include "../methods/rk4.h"
 #include "../methods/sb.h"
+#include "../methods/sundman.h"
 #include "../methods/sv.h"
+#include "../methods/taylor.h"
 
 //Find the Poincaré map of a Hénon Heiles system
 
-Matrix<double, 2, Dynamic> poincare(const Ref<const Matrix<double, 4, Dynamic>> Y);
\ No newline at end of file
+//Any number of other sections are found in one pass over a trajectory with poincare_sections.
+//A section is the surface g(y) = normal·y + energy H(y) - offset = 0 (a hyperplane in p1, p2, q1, q2,
+//a level set of the energy, or a mix), crossed upwards (g goes from negative to positive),
+//downwards or both. The columns are read one block of SECTION_BLOCK columns at a time:
+//g of every section is computed for the block in vectorized loops while it is in the cache,
+//the positions of the sign changes are gathered without branches, and only the crossings are
+//visited again to interpolate them (linearly, as in poincare)
+
+//Number of columns in each block (32 KiB of a matrix, so a block stays in the L1 cache)
+constexpr std::int64_t SECTION_BLOCK = 1024;
+
+//Direction of the crossings of a section
+constexpr int SECTION_UP = 1;       //g goes from negative to positive
+constexpr int SECTION_DOWN = -1;    //g goes from positive to negative
+constexpr int SECTION_BOTH = 0;     //Either
+
+struct Section
+{
+    Array<double, 4, 1> normal = Array<double, 4, 1>::Zero();   //Weights of p1, p2, q1, q2 in g
+    double energy = 0;                                          //Weight of H in g
+    double offset = 0;                                          //Value of the rest of g on the section
+    int direction = SECTION_BOTH;                               //Crossings that are found
+};
+
+Section create_section(const Ref<const Array<double, 4, 1>> normal, const double& offset, const int& direction = SECTION_BOTH);
+Section create_energy_section(const double& level, const int& direction = SECTION_BOTH);
+std::vector<Matrix<double, 5, Dynamic>> poincare_sections(const Ref<const Matrix<double, 4, Dynamic>> Y, const std::vector<Section>& sections);
+
+Matrix<double, 2, Dynamic> poincare(const Ref<const Matrix<double, 4, Dynamic>> Y);
+Matrix<double, 2, Dynamic> poincare(const CompressedTrajectory& C);
+Matrix<double, 2, Dynamic> poincare(const Trajectory& T);
\ No newline at end of file
@@ -0,0 +1,52 @@
+#include "streaming.h"
+
+/**
+ * @brief 
+ * Compute the energy drift and Poincaré map of a run without storing it,
+ * the streaming counterpart of hamiltonian() and poincare() on a computed matrix
+ * 
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @return StreamingResult 
+ */
+static StreamingResult compute_streaming_impl(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h)
+{
+    StreamingResult result;
+    result.H_0 = energy(y0);
+
+    //Section points, stored as (q2, p2) pairs
+    std::vector<double> points;
+    Array<double, 4, 1> y_prev = y0;
+
+    result.cols = stream_method(method, t_0, t_end, y0, h, 
+        [&](const std::int64_t& j, const Ref<const Array<double, 4, 1>> y)
+        {
+            double drift = energy(y) - result.H_0;
+            result.max_drift = std::max(result.max_drift, std::abs(drift));
+            result.final_drift = drift;
+
+            //Same crossing and interpolation as poincare()
+            if (j > 0 && y[0] > 0 && y[2] * y_prev[2] < 0)
+            {
+                double lam = y_prev[2]/(y_prev[2] - y[2]);
+                points.push_back(lam * y[3] + (1 - lam) * y_prev[3]);
+                points.push_back(lam * y[1] + (1 - lam) * y_prev[1]);
+            }
+            y_prev = y;
+        });
+
+    result.section = Eigen::Map<Matrix<double, 2, Dynamic>>(points.data(), 2, points.size()/2);
+
+    return result;
+}
+
+//The streaming analysis compiled for each instruction set (see dispatch.h)
+HHP_MULTIVERSION(
+    compute_streaming, compute_streaming_impl,
+    (const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h),
+    (method, t_0, t_end, y0, h),
+    StreamingResult
+)
@@ -0,0 +1,80 @@
+#pragma once
+
+#include "poincare.h"
+
+//Analyse a run while it is computed, without storing it
+//Meant for runs whose stored output would not fit in memory (see check_storage)
+
+struct StreamingResult
+{
+    std::int64_t cols = 0;                  //Number of analysed columns (every SKIP_STORAGE-th iteration)
+    double H_0 = 0;                         //Energy of the initial condition
+    double max_drift = 0;                   //Largest |H - H_0| of the run
+    double final_drift = 0;                 //H - H_0 at t_end
+    Matrix<double, 2, Dynamic> section;     //The Poincaré map
+};
+
+/**
+ * @brief 
+ * Integrate with one of the methods chosen by name, and hand every column the method
+ * would store to store(j, y) instead of storing it (see integrate_stored)
+ * 
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param t_0 start time
+ * @param t_end end time
+ * @param y0 initial condition
+ * @param h length of timestep
+ * @param store Analyses column j with the values y
+ * @return int64_t number of columns
+ */
+template <typename Store>
+std::int64_t stream_method(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h, Store store)
+{
+    if (method == "rk4")
+    {
+        Matrix<double, 4, 4> Y_vec = Matrix<double, 4, 4>::Zero(4, 4);
+        return integrate_stored(t_0, t_end, y0, h, 
+            [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+            {
+                kutta_iteration(y, Y_vec, step_size);
+            }, store);
+    }
+    if (method == "sb")
+    {
+        Matrix<double, 4, 3> Y_vec = Matrix<double, 4, 3>::Zero(4, 3);
+        return integrate_stored(t_0, t_end, y0, h, 
+            [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+            {
+                sb_iteration(y, Y_vec, step_size);
+            }, store);
+    }
+    if (method == "kahans")
+    {
+        Matrix<double, 4, 4> A = Matrix<double, 4, 4>::Identity(4, 4);
+        Matrix<double, 4, 1> b = Array<double, 4, 1>::Zero(4);
+        return integrate_stored(t_0, t_end, y0, h, 
+            [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+            {
+                kahans_iteration(y, step_size, A, b);
+                y = A.partialPivLu().solve(b).array();
+            }, store);
+    }
+    if (method == "sv")
+    {
+        Array<double, 2, 1> q_next;
+        sv_half_force(HenonHeiles(), y0, h, q_next);
+        return integrate_stored(t_0, t_end, y0, h, 
+            [&](Ref<Array<double, 4, 1>> y, const double& step_size)
+            {
+                //Only the last step can be shorter than h
+                if (step_size != h)
+                    sv_half_force(HenonHeiles(), y, step_size, q_next);
+
+                henon_heiles_sv(y, step_size, q_next);
+            }, store);
+    }
+
+    throw std::invalid_argument("stream_method: unknown method " + method);
+}
+
+StreamingResult compute_streaming(const std::string& method, const double& t_0, const double& t_end, const Ref<const Array<double, 4, 1>> y0, const double& h);
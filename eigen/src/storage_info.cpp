@@ -5,6 +5,30 @@
 // store every skip_storage-th value in the matrix
 const int SKIP_STORAGE = 1;
 
+// write a checkpoint every checkpoint_interval-th iteration (0 to disable)
+const int CHECKPOINT_INTERVAL = 0;
+
+// update the progress counters every telemetry_interval-th iteration, and write them every
+// telemetry_period seconds (0 to disable)
+const int TELEMETRY_INTERVAL = 1000000;
+const double TELEMETRY_PERIOD = 1.0;
+
+// refuse to store more than max_storage_bytes for a single run (16 GiB)
+const std::int64_t MAX_STORAGE_BYTES = std::int64_t(16) << 30;
+
+// allocate large stored output with normal (0), transparent huge (1) or explicit huge (2) pages
+const int HUGE_PAGES = 1;
+
+// touch the pages of a stored run in parallel before it is computed
+const bool PARALLEL_FIRST_TOUCH = false;
+
+// keep at most cache_max_bytes of computed results in cache_dir (0 to disable, e.g. 32 GiB is std::int64_t(32) << 30)
+const std::int64_t CACHE_MAX_BYTES = 0;
+const std::string cache_dir = "../cache";
+
+// cache the trajectories too, not only the results of the analyses
+const bool CACHE_TRAJECTORIES = false;
+
 // Path to csv file to store the computed hamiltonians
 const std::string hamiltonians_file = "../output/hamiltonians";
 
@@ -18,4 +42,28 @@ const std::string poincare_file_sb = "../output/poincare_sb";
 const std::string poincare_file_kahans = "../output/poincare_kahans";
 
 //Path to csv file to store the computed Poincaré for Störmer-Verlet
-const std::string poincare_file_sv = "../output/poincare_sv";
\ No newline at end of file
+const std::string poincare_file_sv = "../output/poincare_sv";
+
+// Paths to the checkpoint files of each method
+const std::string checkpoint_file_rk4 = "../output/checkpoint_rk4.bin";
+const std::string checkpoint_file_sb = "../output/checkpoint_sb.bin";
+const std::string checkpoint_file_kahans = "../output/checkpoint_kahans.bin";
+const std::string checkpoint_file_sv = "../output/checkpoint_sv.bin";
+
+// Paths to csv files to store the statistics and section points of the MPI sweep
+const std::string sweep_stats_file = "../output/sweep_stats";
+const std::string sweep_poincare_file = "../output/sweep_poincare";
+
+// Path to csv file to store the work-precision table of the benchmark
+const std::string work_precision_file = "../output/work_precision.csv";
+
+// Paths to csv files to store the basin raster, escape times and statistics of the escape basins
+const std::string escape_basin_file = "../output/escape_basin.csv";
+const std::string escape_time_file = "../output/escape_time.csv";
+const std::string escape_stats_file = "../output/escape_stats.csv";
+
+// Path to the Prometheus text file with the progress of the running integrations
+const std::string telemetry_file = "../output/hhp.prom";
+
+// Path to csv file to store the results of the orbits of an ensemble, one row per orbit
+const std::string ensemble_file = "../output/ensemble.csv";
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <string>
 
 // Skip_storage is the number of iterations during computation that gets skipped before storing
@@ -7,6 +8,38 @@
 // e.g. store every skip_storage-th value in the matrix
 extern const int SKIP_STORAGE;
 
+// Checkpoint_interval is the number of iterations between each checkpoint of a running
+// integration, so a killed run can be resumed. 0 disables checkpointing (HHP_CHECKPOINT_INTERVAL overrides it)
+extern const int CHECKPOINT_INTERVAL;
+
+// Telemetry_interval is the number of iterations between each update of the progress counters of a
+// running integration, and telemetry_period the seconds between each write of them to telemetry_file
+// (see telemetry.h). 0 disables the telemetry
+extern const int TELEMETRY_INTERVAL;
+extern const double TELEMETRY_PERIOD;
+
+// Max_storage_bytes is the largest amount of memory the stored output of a single run may use.
+// Longer runs are refused, and should use a streaming method instead
+extern const std::int64_t MAX_STORAGE_BYTES;
+
+// Huge_pages chooses the pages large stored output is allocated with (see memory.h):
+// 0 normal pages, 1 transparent huge pages, 2 explicit huge pages (falls back to transparent
+// ones if none are reserved in /proc/sys/vm/nr_hugepages)
+extern const int HUGE_PAGES;
+
+// Parallel_first_touch places the pages of a stored run (matrix or trajectory) on the NUMA nodes of
+// the threads of a parallel pass over it outside a parallel region (see first_touch), instead of the
+// node of the thread computing it
+extern const bool PARALLEL_FIRST_TOUCH;
+
+// Cache_max_bytes is the largest size of the cache of computed trajectories and analysis results
+// in cache_dir (see cache.h), the least recently used results are removed beyond it. 0 disables the cache
+extern const std::int64_t CACHE_MAX_BYTES;
+extern const std::string cache_dir;
+
+// Cache_trajectories also caches the (large) trajectories, not only the hamiltonians and Poincaré maps
+extern const bool CACHE_TRAJECTORIES;
+
 // File with the paths to store computed data
 
 // Path to csv file to store the computed hamiltonians
@@ -22,4 +55,28 @@ extern const std::string poincare_file_sb;
 extern const std::string poincare_file_kahans;
 
 //Path to csv file to store the computed Poincaré for Störmer-Verlet
-extern const std::string poincare_file_sv;
\ No newline at end of file
+extern const std::string poincare_file_sv;
+
+// Paths to the checkpoint files of each method (the stored columns are kept in file + ".cols")
+extern const std::string checkpoint_file_rk4;
+extern const std::string checkpoint_file_sb;
+extern const std::string checkpoint_file_kahans;
+extern const std::string checkpoint_file_sv;
+
+// Paths to csv files to store the statistics and section points of the MPI sweep
+extern const std::string sweep_stats_file;
+extern const std::string sweep_poincare_file;
+
+// Path to csv file to store the work-precision table of the benchmark
+extern const std::string work_precision_file;
+
+// Paths to csv files to store the basin raster, escape times and statistics of the escape basins
+extern const std::string escape_basin_file;
+extern const std::string escape_time_file;
+extern const std::string escape_stats_file;
+
+// Path to the Prometheus text file with the progress of the running integrations
+extern const std::string telemetry_file;
+
+// Path to csv file to store the results of the orbits of an ensemble, one row per orbit
+extern const std::string ensemble_file;
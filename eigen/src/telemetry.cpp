@@ -0,0 +1,303 @@
+#include "telemetry.h"
+
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <deque>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <mutex>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+//The tasks of all runs since the reporter started, a deque so their addresses never change
+static std::deque<TelemetryTask> telemetry_tasks;
+static std::mutex telemetry_mutex;
+
+static std::thread telemetry_reporter;
+static std::condition_variable telemetry_stop_cv;
+static bool telemetry_stop = false;
+static std::atomic<bool> telemetry_running{false};
+
+//Set once a write of telemetry_file failed, so the failure is only reported once (reporter thread only)
+static bool telemetry_write_failed = false;
+
+/**
+ * @brief
+ * Count the Poincaré crossings in the stored columns not checked yet, the same ones poincare finds
+ *
+ * @param tm the telemetry of the run
+ * @param Y the stored columns
+ * @param stored number of columns stored so far
+ */
+static void scan_crossings(Telemetry& tm, const Ref<const Matrix<double, 4, Dynamic>> Y, const std::int64_t& stored)
+{
+    for (std::int64_t i = tm.scanned; i < stored; i++)
+    {
+        if (Y(0, i) > 0 && Y(2, i) * Y(2, i-1) < 0)
+            tm.crossings++;
+    }
+    tm.scanned = std::max(tm.scanned, stored);
+}
+
+/**
+ * @brief
+ * Create the telemetry of a run, with a new task if the reporter is running
+ *
+ * @param method name of the integrator
+ * @param t_0 start time
+ * @param t_end end time
+ * @param h length of timestep
+ * @param y0 initial condition
+ * @param n number of time steps of the run (see create_H)
+ * @param first_step first iteration of the run (after a resumed checkpoint)
+ * @return Telemetry
+ */
+Telemetry create_telemetry(const std::string& method, const double& t_0, const double& t_end, const double& h, const Ref<const Array<double, 4, 1>> y0, const std::int64_t& n, const std::int64_t& first_step)
+{
+    Telemetry tm;
+    if (!telemetry_running.load(std::memory_order_relaxed) || TELEMETRY_INTERVAL <= 0)
+        return tm;
+
+    tm.t_0 = t_0;
+    tm.h = h;
+    tm.H_0 = potential_energy(HenonHeiles(), y0);
+    tm.next_step = first_step + TELEMETRY_INTERVAL - 1;
+
+    std::lock_guard<std::mutex> lock(telemetry_mutex);
+    TelemetryTask& task = telemetry_tasks.emplace_back();
+    task.name = method;
+    task.id = int(telemetry_tasks.size()) - 1;
+    task.n_steps = n - 1;
+    task.t_end = t_end;
+    task.first_steps = first_step - 1;
+    task.started = std::chrono::steady_clock::now();
+    task.steps.store(first_step - 1, std::memory_order_relaxed);
+    task.t.store(t_0 + (first_step - 1)*h, std::memory_order_relaxed);
+    tm.task = &task;
+
+    return tm;
+}
+
+/**
+ * @brief
+ * Update the counters of a run after iteration step, and set the next iteration to update them at
+ *
+ * @param tm the telemetry of the run
+ * @param step the iteration just done
+ * @param y the values of the system after it
+ * @param Y the stored columns
+ * @param stored number of columns stored so far
+ */
+void update_telemetry(Telemetry& tm, const std::int64_t& step, const Ref<const Array<double, 4, 1>> y, const Ref<const Matrix<double, 4, Dynamic>> Y, const std::int64_t& stored)
+{
+    scan_crossings(tm, Y, stored);
+
+    tm.task->t.store(tm.t_0 + step*tm.h, std::memory_order_relaxed);
+    tm.task->drift.store(std::abs(potential_energy(HenonHeiles(), y) - tm.H_0), std::memory_order_relaxed);
+    tm.task->crossings.store(tm.crossings, std::memory_order_relaxed);
+    tm.task->steps.store(step, std::memory_order_relaxed);
+
+    tm.next_step = (step > INT64_MAX - TELEMETRY_INTERVAL) ? INT64_MAX : step + TELEMETRY_INTERVAL;
+}
+
+/**
+ * @brief
+ * Update the counters of a finished run, and mark it as done
+ *
+ * @param tm the telemetry of the run
+ * @param y the values of the system at t_end
+ * @param Y all the stored columns
+ */
+void finish_telemetry(Telemetry& tm, const Ref<const Array<double, 4, 1>> y, const Ref<const Matrix<double, 4, Dynamic>> Y)
+{
+    if (!tm.task)
+        return;
+
+    scan_crossings(tm, Y, Y.cols());
+
+    tm.task->t.store(tm.task->t_end, std::memory_order_relaxed);
+    tm.task->drift.store(std::abs(potential_energy(HenonHeiles(), y) - tm.H_0), std::memory_order_relaxed);
+    tm.task->crossings.store(tm.crossings, std::memory_order_relaxed);
+    tm.task->steps.store(tm.task->n_steps, std::memory_order_relaxed);
+    tm.task->done.store(true, std::memory_order_relaxed);
+}
+
+//What the reporter remembers of a task from its previous write, for the rates
+struct TelemetrySeen
+{
+    std::int64_t steps = -1;
+    std::chrono::steady_clock::time_point last_write;
+    std::chrono::steady_clock::time_point last_progress;
+};
+
+/**
+ * @brief
+ * Write one metric of all tasks in the Prometheus text format
+ */
+template <typename Value>
+static void write_metric(std::ostringstream& out, const char* name, const char* type, const char* help, const std::vector<std::string>& labels, Value value)
+{
+    out << "# HELP " << name << " " << help << "\n";
+    out << "# TYPE " << name << " " << type << "\n";
+    for (std::size_t k = 0; k < labels.size(); k++)
+    {
+        out << name << labels[k] << " ";
+        //Prometheus spells these out
+        if (std::isnan(double(value(k))))
+            out << "NaN";
+        else
+            out << value(k);
+        out << "\n";
+    }
+}
+
+/**
+ * @brief
+ * Write the counters of all tasks to telemetry_file, replacing it at once (written to a temporary
+ * file that is renamed), so a scraper never reads half a file
+ *
+ * @param seen what the reporter saw of each task at its previous write
+ */
+static void write_telemetry(std::vector<TelemetrySeen>& seen)
+{
+    auto now = std::chrono::steady_clock::now();
+
+    //A snapshot of the counters, the integrators keep going while it is written
+    std::vector<std::string> labels;
+    std::vector<std::int64_t> steps, n_steps, crossings;
+    std::vector<double> t, t_end, drift, rate, eta, stalled;
+    std::vector<int> done;
+    std::vector<std::int64_t> first_steps;
+    std::vector<std::chrono::steady_clock::time_point> started;
+    {
+        std::lock_guard<std::mutex> lock(telemetry_mutex);
+        for (const TelemetryTask& task : telemetry_tasks)
+        {
+            labels.push_back("{task=\"" + task.name + "\",id=\"" + std::to_string(task.id) + "\"}");
+            steps.push_back(task.steps.load(std::memory_order_relaxed));
+            n_steps.push_back(task.n_steps);
+            crossings.push_back(task.crossings.load(std::memory_order_relaxed));
+            t.push_back(task.t.load(std::memory_order_relaxed));
+            t_end.push_back(task.t_end);
+            drift.push_back(task.drift.load(std::memory_order_relaxed));
+            done.push_back(task.done.load(std::memory_order_relaxed));
+            first_steps.push_back(task.first_steps);
+            started.push_back(task.started);
+        }
+    }
+
+    seen.resize(labels.size());
+    for (std::size_t k = 0; k < labels.size(); k++)
+    {
+        TelemetrySeen& s = seen[k];
+        //A new task is measured from its start
+        if (s.steps < 0)
+        {
+            s.last_write = started[k];
+            s.last_progress = started[k];
+            s.steps = first_steps[k];
+        }
+
+        double seconds = std::chrono::duration<double>(now - s.last_write).count();
+        rate.push_back((seconds > 0) ? (steps[k] - s.steps)/seconds : 0);
+        eta.push_back(done[k] ? 0 : (rate[k] > 0) ? (n_steps[k] - steps[k])/rate[k] : NAN);
+
+        if (steps[k] != s.steps)
+            s.last_progress = now;
+        stalled.push_back(done[k] ? 0 : std::chrono::duration<double>(now - s.last_progress).count());
+
+        s.steps = steps[k];
+        s.last_write = now;
+    }
+
+    std::ostringstream out;
+    out.precision(17);
+    write_metric(out, "hhp_steps_total", "counter", "Steps done by the run", labels, [&](std::size_t k) { return steps[k]; });
+    write_metric(out, "hhp_steps_target", "gauge", "Steps of the whole run", labels, [&](std::size_t k) { return n_steps[k]; });
+    write_metric(out, "hhp_time", "gauge", "Current time of the run", labels, [&](std::size_t k) { return t[k]; });
+    write_metric(out, "hhp_time_end", "gauge", "End time of the run", labels, [&](std::size_t k) { return t_end[k]; });
+    write_metric(out, "hhp_crossings_total", "counter", "Poincare crossings found so far", labels, [&](std::size_t k) { return crossings[k]; });
+    write_metric(out, "hhp_energy_drift", "gauge", "Current |H - H_0|", labels, [&](std::size_t k) { return drift[k]; });
+    write_metric(out, "hhp_steps_per_second", "gauge", "Steps per second since the previous write", labels, [&](std::size_t k) { return rate[k]; });
+    write_metric(out, "hhp_eta_seconds", "gauge", "Estimated seconds left at the current rate", labels, [&](std::size_t k) { return eta[k]; });
+    write_metric(out, "hhp_seconds_since_progress", "gauge", "Seconds since the steps of an unfinished run last changed", labels, [&](std::size_t k) { return stalled[k]; });
+    write_metric(out, "hhp_done", "gauge", "1 if the run has finished", labels, [&](std::size_t k) { return done[k]; });
+
+    std::string tmp = telemetry_file + ".tmp";
+    std::ofstream file(tmp, std::ios::trunc);
+    file << out.str();
+    file.close();
+
+    //A failed write leaves the previous file in place
+    std::error_code ec;
+    if (file)
+        std::filesystem::rename(tmp, telemetry_file, ec);
+    if (file && !ec)
+        return;
+
+    std::filesystem::remove(tmp, ec);
+    if (!telemetry_write_failed)
+        std::clog << "hhp: cannot write the telemetry to " << telemetry_file << ", the progress is not reported" << std::endl;
+    telemetry_write_failed = true;
+}
+
+/**
+ * @brief
+ * Start the reporter thread, which writes the counters of all runs started from now on
+ * to telemetry_file every TELEMETRY_PERIOD seconds (see telemetry.h). Does nothing if
+ * TELEMETRY_INTERVAL is 0
+ */
+void start_telemetry()
+{
+    if (TELEMETRY_INTERVAL <= 0 || telemetry_running.load())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(telemetry_mutex);
+        telemetry_stop = false;
+    }
+    telemetry_running.store(true);
+
+    telemetry_reporter = std::thread([]()
+    {
+        std::vector<TelemetrySeen> seen;
+        auto period = std::chrono::duration<double>(TELEMETRY_PERIOD);
+
+        std::unique_lock<std::mutex> lock(telemetry_mutex);
+        while (!telemetry_stop_cv.wait_for(lock, period, []() { return telemetry_stop; }))
+        {
+            lock.unlock();
+            write_telemetry(seen);
+            lock.lock();
+        }
+        lock.unlock();
+
+        //The final state of all runs
+        write_telemetry(seen);
+    });
+}
+
+/**
+ * @brief
+ * Stop the reporter thread after a last write, and forget the tasks.
+ * Only call it once the runs started after start_telemetry are done
+ */
+void stop_telemetry()
+{
+    if (!telemetry_running.load())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(telemetry_mutex);
+        telemetry_stop = true;
+    }
+    telemetry_stop_cv.notify_one();
+    telemetry_reporter.join();
+
+    telemetry_running.store(false);
+    std::lock_guard<std::mutex> lock(telemetry_mutex);
+    telemetry_tasks.clear();
+}
@@ -0,0 +1,55 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <string>
+
+#include "utils.h"
+
+// Live progress of long runs
+// Every run of an integrator started while the reporter is running gets a task with atomic counters
+// (steps done, current t, Poincaré crossings found so far and the current |H - H_0|). The integrator
+// updates them every TELEMETRY_INTERVAL-th iteration, and the reporter thread writes all tasks to
+// telemetry_file in the Prometheus text format every TELEMETRY_PERIOD seconds, with the throughput,
+// the estimated time left and the time since each task last made progress.
+// Without the reporter the integrators only compare the iteration with INT64_MAX, as for checkpoints
+
+//Counters of one run, written by the integrator and read by the reporter
+//Each task has its own cache line, so integrators on different threads do not share one
+struct alignas(64) TelemetryTask
+{
+    std::string name;
+    int id = 0;
+    std::int64_t n_steps = 0;                   //Number of steps of the whole run
+    double t_end = 0;
+    std::int64_t first_steps = 0;               //Steps already done when the run started (resumed checkpoint)
+    std::chrono::steady_clock::time_point started;
+
+    std::atomic<std::int64_t> steps{0};         //Steps done
+    std::atomic<double> t{0};                   //Current time
+    std::atomic<std::int64_t> crossings{0};     //Poincaré crossings in the columns stored so far
+    std::atomic<double> drift{0};               //Current |H - H_0|
+    std::atomic<bool> done{false};
+};
+
+//State of the telemetry of a run, kept by the integrator
+struct Telemetry
+{
+    TelemetryTask* task = nullptr;
+    double t_0 = 0;
+    double h = 0;
+    double H_0 = 0;
+
+    //Iteration at which the counters are updated next (INT64_MAX if the reporter is not running)
+    std::int64_t next_step = INT64_MAX;
+
+    //Stored columns already checked for crossings, and the crossings found in them
+    std::int64_t scanned = 1;
+    std::int64_t crossings = 0;
+};
+
+Telemetry create_telemetry(const std::string& method, const double& t_0, const double& t_end, const double& h, const Ref<const Array<double, 4, 1>> y0, const std::int64_t& n, const std::int64_t& first_step);
+void update_telemetry(Telemetry& tm, const std::int64_t& step, const Ref<const Array<double, 4, 1>> y, const Ref<const Matrix<double, 4, Dynamic>> Y, const std::int64_t& stored);
+void finish_telemetry(Telemetry& tm, const Ref<const Array<double, 4, 1>> y, const Ref<const Matrix<double, 4, Dynamic>> Y);
+void start_telemetry();
+void stop_telemetry();
@@ -0,0 +1,57 @@
+#include "trajectory.h"
+
+/**
+ * @brief 
+ * Allocate a trajectory with the given number of columns, the values are not initialized
+ * 
+ * @param cols number of columns
+ * @return Trajectory 
+ */
+Trajectory create_trajectory(const std::int64_t& cols)
+{
+    //Pad every component to a whole number of cache lines, so all four start aligned
+    constexpr std::int64_t line = TRAJECTORY_ALIGN/sizeof(double);
+
+    Trajectory T;
+    T.cols = cols;
+    T.stride = (cols + line - 1) / line * line;
+    T.data.resize(4*T.stride);
+
+    //Place the pages of each component with the blocks and schedule of the parallel passes over it
+    for (int r = 0; r < 4; r++)
+        first_touch(trajectory_data(T, r), T.stride, sizeof(double));
+
+    return T;
+}
+
+/**
+ * @brief 
+ * Copy a matrix computed by one of the methods into a trajectory
+ * 
+ * @param Y the matrix
+ * @return Trajectory 
+ */
+Trajectory to_trajectory(const Ref<const Matrix<double, 4, Dynamic>> Y)
+{
+    Trajectory T = create_trajectory(Y.cols());
+    for (int r = 0; r < 4; r++)
+        trajectory_row(T, r) = Y.row(r).transpose().array();
+
+    return T;
+}
+
+/**
+ * @brief 
+ * Copy a trajectory back into a matrix
+ * 
+ * @param T the trajectory
+ * @return Matrix<double, 4, Dynamic> 
+ */
+Matrix<double, 4, Dynamic> to_matrix(const Trajectory& T)
+{
+    Matrix<double, 4, Dynamic> Y(4, T.cols);
+    for (int r = 0; r < 4; r++)
+        Y.row(r) = trajectory_row(T, r).matrix().transpose();
+
+    return Y;
+}
@@ -0,0 +1,116 @@
+#pragma once
+
+#include <cstdint>
+#include <new>
+#include <utility>
+#include <vector>
+
+#include "memory.h"
+#include "utils.h"
+
+// Structure-of-arrays storage of computed matrices
+// Each of the four components is stored as its own contiguous array, starting on a
+// 64-byte boundary (one cache line, and one AVX-512 register), so passes over the
+// components (like the hamiltonian) read every array with unit stride and vectorize
+
+//Alignment of each component, in bytes
+constexpr int TRAJECTORY_ALIGN = STORAGE_ALIGN;
+
+/**
+ * @brief 
+ * Allocator for std::vector returning memory aligned to TRAJECTORY_ALIGN bytes (see memory.h).
+ * Values are default initialized, so resizing a vector of doubles leaves them uninitialized
+ * instead of zeroing buffers that are overwritten anyway
+ */
+template <typename T>
+struct AlignedAllocator
+{
+    using value_type = T;
+
+    AlignedAllocator() = default;
+    template <typename U>
+    AlignedAllocator(const AlignedAllocator<U>&) {}
+
+    T* allocate(std::size_t n)
+    {
+        return static_cast<T*>(allocate_storage(n*sizeof(T)));
+    }
+
+    void deallocate(T* p, std::size_t n)
+    {
+        free_storage(p, n*sizeof(T));
+    }
+
+    template <typename U>
+    void construct(U* p)
+    {
+        ::new(static_cast<void*>(p)) U;
+    }
+
+    template <typename U, typename... Args>
+    void construct(U* p, Args&&... args)
+    {
+        ::new(static_cast<void*>(p)) U(std::forward<Args>(args)...);
+    }
+
+    template <typename U>
+    bool operator==(const AlignedAllocator<U>&) const { return true; }
+    template <typename U>
+    bool operator!=(const AlignedAllocator<U>&) const { return false; }
+};
+
+struct Trajectory
+{
+    std::int64_t cols = 0;      //Number of stored columns
+    std::int64_t stride = 0;    //Distance between the components, cols padded to a whole number of cache lines
+    std::vector<double, AlignedAllocator<double>> data;
+};
+
+//A component of a trajectory as an Eigen array, aligned so Eigen may use aligned loads
+typedef Eigen::Map<Array<double, Dynamic, 1>, Eigen::Aligned64> TrajectoryRow;
+typedef Eigen::Map<const Array<double, Dynamic, 1>, Eigen::Aligned64> ConstTrajectoryRow;
+
+Trajectory create_trajectory(const std::int64_t& cols);
+Trajectory to_trajectory(const Ref<const Matrix<double, 4, Dynamic>> Y);
+Matrix<double, 4, Dynamic> to_matrix(const Trajectory& T);
+
+/**
+ * @brief 
+ * Pointer to the (aligned) start of component r of a trajectory
+ */
+inline double* trajectory_data(Trajectory& T, const int& r)
+{
+    return T.data.data() + r*T.stride;
+}
+
+inline const double* trajectory_data(const Trajectory& T, const int& r)
+{
+    return T.data.data() + r*T.stride;
+}
+
+/**
+ * @brief 
+ * Component r of a trajectory as an Eigen array
+ */
+inline TrajectoryRow trajectory_row(Trajectory& T, const int& r)
+{
+    return TrajectoryRow(trajectory_data(T, r), T.cols);
+}
+
+inline ConstTrajectoryRow trajectory_row(const Trajectory& T, const int& r)
+{
+    return ConstTrajectoryRow(trajectory_data(T, r), T.cols);
+}
+
+/**
+ * @brief 
+ * Store the values of the system as column j of a trajectory
+ */
+inline void store_column(Trajectory& T, const std::int64_t& j, const Ref<const Array<double, 4, 1>> y)
+{
+    double* p = T.data.data() + j;
+    p[0] = y[0];
+    p[T.stride] = y[1];
+    p[2*T.stride] = y[2];
+    p[3*T.stride] = y[3];
+}
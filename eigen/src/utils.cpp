@@ -1,51 +1,81 @@
 #include "utils.h"
 
+#include "memory.h"
+
 
 /**
  * @brief 
  * Calculate the number of iterations to compute, with a given h
- * if remainder is not zero the last step is the remainder
+ * if the time interval is not divisible by h the last step is the rest of it,
  * otherwise the last step is h
  * 
  * @param t_0 Start time for the system
  * @param t_end End time for the system
  * @param h Timestep length for iterations
- * @return std::tuple<int, int, int, double> number of total iterations, number of elements to store in matrix, SKIP_STORAGE, and last step size
+ * @return std::tuple<std::int64_t, std::int64_t, int, double> number of total iterations, number of elements to store in matrix, SKIP_STORAGE, and last step size
  */
-std::tuple<int, int, int, double> create_H(const double& t_0, const double& t_end, const double& h)
+std::tuple<std::int64_t, std::int64_t, int, double> create_H(const double& t_0, const double& t_end, const double& h)
 {
-    double remainder = std::remainder(t_end - t_0, h);
-
-    //If there is a remainder, the last step is equal to it
-    double last_step = (remainder >= 1e-10) ? remainder : h;
-
     //The total number of iterations
     //Ceil to include the initial condition and +1 to include last step
     double ratio = (t_end - t_0)/h;
-    int n = int(std::ceil(ratio)) + 1;
+
+    //The counts are 64-bit, but guard against runs that would overflow even those
+    if (!(ratio >= 0 && ratio < 9e18))
+        throw std::overflow_error("create_H: the number of iterations does not fit in 64 bits");
+
+    //A ratio within rounding of a whole number takes that many steps, not one more
+    std::int64_t n = std::int64_t(std::ceil(ratio - 1e-10)) + 1;
+
+    //The last step ends exactly at t_end: it is the rest of the interval after n - 2 steps of h,
+    //which is h (exactly) if the time interval is divisible by the time step size
+    double last_step = (t_end - t_0) - double(n - 2)*h;
+    if (std::abs(last_step - h) < 1e-10)
+        last_step = h;
 
     //If all values are to be stored, no more calculations are necessary
     if (SKIP_STORAGE == 1)
-        return std::tuple<int, int, int, double>(n, n, SKIP_STORAGE, last_step);
+        return std::tuple<std::int64_t, std::int64_t, int, double>(n, n, SKIP_STORAGE, last_step);
 
-    //Compute the number of iterations to store, to allocate array memory
-    int m = int(std::ceil(n/SKIP_STORAGE));
+    //The methods store the initial condition, every SKIP_STORAGE-th of the iterations 1, ..., n - 2,
+    //and the last step, so this is exactly the number of columns they write
+    std::int64_t m = (n < 2) ? n : 2 + (n - 2)/SKIP_STORAGE;
 
-    //If the time interval is not divisible by time step size, increase by 1 to include last step
-    if (remainder >= 1e-10)
-    {
-        m++;
-    } else 
-    //If time interval is divisible by time step size
-    {
-        //If the number of iterations (excluding last one) is divisible by skip_storage
-        //Increase by one for last step. If it is not divisible, then add 2 to include 
-        //step before last
-        double storage_remainder = std::remainder(n-1, SKIP_STORAGE);
-        m = (storage_remainder >= 1e-10) ? m + 2 : m + 1;
-    }
+    return std::tuple<std::int64_t, std::int64_t, int, double>(n, m, SKIP_STORAGE, last_step);
+}
 
-    return std::tuple<int, int, int, double>(n, m, SKIP_STORAGE, last_step);
+/**
+ * @brief 
+ * Guard against storing more than MAX_STORAGE_BYTES in memory, which would either fail
+ * to allocate or push the machine into swap. Runs this long should use a streaming method
+ * (see problems/streaming.h) or compressed output instead
+ * 
+ * @param cols number of columns to store
+ * @param rows number of values in each column
+ */
+void check_storage(const std::int64_t& cols, const int& rows)
+{
+    if (double(cols)*rows*sizeof(double) > double(MAX_STORAGE_BYTES))
+        throw std::length_error("check_storage: the stored output of this run does not fit in MAX_STORAGE_BYTES, use a streaming method");
+}
+
+/**
+ * @brief 
+ * Allocate the matrix a run stores its values in. The matrix is not zeroed, since the run
+ * writes every column, and its pages are backed by huge pages (see memory.h)
+ * 
+ * @param cols number of columns to store
+ * @return Matrix<double, 4, Dynamic> the uninitialized matrix
+ */
+Matrix<double, 4, Dynamic> create_Y(const std::int64_t& cols)
+{
+    check_storage(cols);
+
+    Matrix<double, 4, Dynamic> Y(4, cols);
+    advise_storage(Y.data(), Y.size()*sizeof(double));
+    first_touch(Y.data(), cols, 4*sizeof(double));
+
+    return Y;
 }
 
 /**
@@ -55,10 +85,22 @@ std::tuple<int, int, int, double> create_H(const double& t_0, const double& t_en
  * @return the initial condition as a vector
  */
 Array<double, 4, 1> create_init_cond(const double& H_0)
+{
+    return create_init_cond(H_0, 0.45);
+}
+
+/**
+ * @brief Create initial condition for the system, starting at q1 = 0 and p2 = 0
+ * with a given q2 (used for ensembles of orbits with the same energy)
+ * 
+ * @param H_0 Initial energy in the system
+ * @param q2 Initial value of q2
+ * @return the initial condition as a vector
+ */
+Array<double, 4, 1> create_init_cond(const double& H_0, const double& q2)
 {
     double p2 = 0;
     double q1 = 0;
-    double q2 = 0.45;
     double p1 = std::sqrt(2.0/3.0*pow(q2, 3) + 2*H_0 - pow(p2, 2) - pow(q1, 2) - pow(q2, 2) - 2*pow(q1,2)*q2);
 
     return Array<double, 4, 1>(p1, p2, q1, q2);
@@ -75,18 +117,19 @@ Array<double, 4, 1> create_init_cond(const double& H_0)
  */
 Array<double, Dynamic, 1> create_T(const double& t_0, const double& t_end, const double& h)
 {
-    std::tuple<int, int, int, double> vals = create_H(t_0, t_end, h);
-    int n = std::get<0>(vals);
-    int m = std::get<1>(vals);
+    std::tuple<std::int64_t, std::int64_t, int, double> vals = create_H(t_0, t_end, h);
+    std::int64_t n = std::get<0>(vals);
+    std::int64_t m = std::get<1>(vals);
     int skip_storage = std::get<2>(vals);
+    check_storage(m, 1);
 
     Array<double, Dynamic, 1> T = Array<double, Dynamic, 1>::Zero(m);
     T[0] = t_0;
 
     //Current time step
     double curr_time = 0;
-    int storage_index = 1;
-    for (int i = 1; i < n-1; i++)
+    std::int64_t storage_index = 1;
+    for (std::int64_t i = 1; i < n-1; i++)
     {
         curr_time += h;
         if (!(i % skip_storage))
@@ -100,6 +143,29 @@ Array<double, Dynamic, 1> create_T(const double& t_0, const double& t_end, const
     return T;
 }
 
+/**
+ * @brief 
+ * Create a vector containing the output times of dense output,
+ * every dt_out from t_0 up to (and including) t_end
+ * 
+ * @param t_0 start time
+ * @param t_end end time
+ * @param dt_out time between each output
+ * @return T Time vector
+ */
+Array<double, Dynamic, 1> create_T_dense(const double& t_0, const double& t_end, const double& dt_out)
+{
+    //Include t_end if it is a multiple of dt_out, up to floating point error
+    std::int64_t n_out = std::int64_t(std::floor((t_end - t_0)/dt_out + 1e-10)) + 1;
+    check_storage(n_out, 1);
+
+    Array<double, Dynamic, 1> T(n_out);
+    for (std::int64_t k = 0; k < n_out; k++)
+        T[k] = t_0 + k*dt_out;
+
+    return T;
+}
+
 /**
  * @brief 
  * Purely to have an easier time naming files
@@ -1,9 +1,13 @@
 #pragma once
 
+#include <cstdint>
 #include <eigen3/Eigen/Core>
 #include <fstream>
+#include <stdexcept>
 #include <utility>
 
+#include "dispatch.h"
+#include "potentials.h"
 #include "storage_info.h"
 
 using Eigen::Array;
@@ -11,8 +15,29 @@ using Eigen::Dynamic;
 using Eigen::Matrix;
 using Eigen::Ref;
 
-std::tuple<int, int, int, double> create_H(const double& t_0, const double& t_end, const double& h);
+std::tuple<std::int64_t, std::int64_t, int, double> create_H(const double& t_0, const double& t_end, const double& h);
+void check_storage(const std::int64_t& cols, const int& rows = 4);
+Matrix<double, 4, Dynamic> create_Y(const std::int64_t& cols);
 Array<double, 4, 1> create_init_cond(const double& H_0);
+Array<double, 4, 1> create_init_cond(const double& H_0, const double& q2);
 Array<double, Dynamic, 1> create_T(const double& t_0, const double& t_end, const double& h);
+Array<double, Dynamic, 1> create_T_dense(const double& t_0, const double& t_end, const double& dt_out);
 std::string decimal_to_string(double h);
-void matrix_to_CSV(std::string filename, const Ref<const Matrix<double, Dynamic, Dynamic>> M);
\ No newline at end of file
+void matrix_to_CSV(std::string filename, const Ref<const Matrix<double, Dynamic, Dynamic>> M);
+
+/**
+ * @brief Create initial condition for the system with another potential,
+ * at q1 = p2 = 0 and the given q2
+ * 
+ * @param V the potential
+ * @param H_0 Initial energy in the system
+ * @param q2 Initial value of q2
+ * @return the initial condition as a vector
+ */
+template <typename Potential>
+Array<double, 4, 1> create_init_cond(const Potential& V, const double& H_0, const double& q2)
+{
+    double p1 = std::sqrt(2*(H_0 - V.U(0.0, q2)));
+
+    return Array<double, 4, 1>(p1, 0, 0, q2);
+}
@@ -0,0 +1,25 @@
+# Runs the MPI sweep on one rank and on MPI_RANKS ranks, and fails unless both find the same
+# number of section points and the same energy drifts (every job is computed the same way on any rank)
+# Called by CTest with -DMPIEXEC=... -DNUMPROC_FLAG=... -DHHP_MPI=... -DMPI_RANKS=... -DT_END=...
+
+foreach(ranks 1 ${MPI_RANKS})
+    execute_process(
+        COMMAND ${MPIEXEC} ${NUMPROC_FLAG} ${ranks} ${HHP_MPI} ${T_END}
+        OUTPUT_VARIABLE output
+        RESULT_VARIABLE result
+    )
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "hhp_mpi on ${ranks} rank(s) failed (${result}):\n${output}")
+    endif()
+
+    string(REGEX MATCH "Section points: [0-9]+" points_${ranks} "${output}")
+    string(REGEX MATCH "Max energy drift[^\n]*" drift_${ranks} "${output}")
+    if (NOT points_${ranks})
+        message(FATAL_ERROR "hhp_mpi on ${ranks} rank(s) printed no section points:\n${output}")
+    endif()
+    message(STATUS "${ranks} rank(s): ${points_${ranks}}, ${drift_${ranks}}")
+endforeach()
+
+if (NOT points_1 STREQUAL points_${MPI_RANKS} OR NOT drift_1 STREQUAL drift_${MPI_RANKS})
+    message(FATAL_ERROR "the sweep on ${MPI_RANKS} ranks differs from the sweep on one rank")
+endif()
@@ -0,0 +1,132 @@
+#pragma once
+
+// Reference values for the regression tests
+// The golden states were computed with the baseline kernels, for the orbit with
+// H_0 = 1/12 and q2 = 0.45 (create_init_cond), from t = 0 with h = 1/64.
+// The step is a power of two, so the eigen and armadillo backends take exactly the same
+// steps, and the armadillo tests (armadillo/tests) check against the same values.
+
+constexpr double GOLDEN_H_0 = 1.0/12.0;
+constexpr double GOLDEN_h = 0.015625;
+
+//States at t = GOLDEN_t_end, (p1, p2, q1, q2)
+constexpr double GOLDEN_t_end = 100;
+constexpr double GOLDEN_rk4[4] = {-0.2123348091927999, 0.31918383487872959, 0.07525675851747729, -0.11939996679957586};
+constexpr double GOLDEN_sb[4] = {-0.21236677181236166, 0.31916204121975256, 0.075245258497495179, -0.11938110419554944};
+constexpr double GOLDEN_kahans[4] = {-0.21245082310468505, 0.31873833666978246, 0.075747187004992597, -0.12011162764164741};
+constexpr double GOLDEN_sv[4] = {-0.21229698858828666, 0.31941173940022649, 0.074977777323989109, -0.11900005648782495};
+
+//Largest difference allowed to the golden states. Other instruction sets and
+//compilers may contract or reorder operations, which changes the last few digits
+constexpr double GOLDEN_TOLERANCE = 1e-9;
+
+//Energy drift bounds, max |H - H_0| up to t = DRIFT_t_end
+//(measured: 3.4e-6 for Störmer-Verlet and 5.1e-6 for Kahan's method)
+constexpr double DRIFT_t_end = 1000;
+constexpr double DRIFT_BOUND_sv = 5e-6;
+constexpr double DRIFT_BOUND_kahans = 1e-5;
+
+//Number of crossings of the Poincaré section up to t = POINCARE_t_end,
+//a crossing right on the section may be counted by one method but not another
+constexpr double POINCARE_t_end = 1000;
+constexpr int POINCARE_CROSSINGS = 156;
+constexpr int POINCARE_TOLERANCE = 1;
+
+//Timed runs, ns/step (best of PERFORMANCE_REPEATS) may grow by at most PERFORMANCE_TOLERANCE
+//(relative) compared to the baseline stored on the same machine. The tolerance is loose,
+//as timings on a busy machine vary by tens of percent, and can be set with HHP_PERF_TOLERANCE
+constexpr double PERFORMANCE_t_end = 10000;
+constexpr int PERFORMANCE_REPEATS = 5;
+constexpr double PERFORMANCE_TOLERANCE = 0.5;
+
+//Returned by the timed runs when they only stored a baseline, so CTest reports them as skipped
+//instead of passed (SKIP_RETURN_CODE in CMakeLists.txt)
+constexpr int PERFORMANCE_SKIPPED = 77;
+
+//Run killed and resumed from its checkpoint, which must give the same bits as a run that was never killed.
+//It is long enough to still be running some time after its first checkpoint. The projected run is
+//projected every CHECKPOINT_PROJECT_EVERY steps, and its cost only counts the steps after the checkpoint
+constexpr double CHECKPOINT_t_end = 20000;
+constexpr const char* CHECKPOINT_EVERY = "10000";
+constexpr int CHECKPOINT_PROJECT_EVERY = 10;
+
+//Pure tone exp(i FREQUENCY_omega t), sampled FREQUENCY_SAMPLES times every FREQUENCY_dt,
+//whose frequency naff_frequency has to find within FREQUENCY_TOLERANCE (between two FFT bins)
+constexpr double FREQUENCY_omega = 0.7316;
+constexpr double FREQUENCY_dt = 0.05;
+constexpr int FREQUENCY_SAMPLES = 4096;
+constexpr double FREQUENCY_TOLERANCE = 1e-10;
+
+//Runs analysed while they are computed, which must give the same bits as analysing the stored runs
+//(with the baseline kernels). The run fills the ring of blocks several times, and ends inside a block
+constexpr double PIPELINE_t_end = 1000.3;
+
+//Compressed runs, which must decompress to the same bits as the stored runs. The run is several
+//blocks of COMPRESSED_BLOCK columns long, and ends inside a block
+constexpr double COMPRESSED_t_end = 200;
+constexpr const char* COMPRESSED_FILE = "compressed_test.bin";
+
+//Gauss-Legendre methods of 1, 2 and 3 stages. The global error at GAUSS_ORDER_t_end, against a
+//Taylor series run, has to fall as h^(2s) from GAUSS_ORDER_h to GAUSS_ORDER_h/2 (within GAUSS_ORDER_TOLERANCE).
+//Up to GAUSS_DRIFT_t_end the energy error stays below its bound (measured: 5.2e-5, 2.4e-8 and 2.3e-12),
+//and grows by at most GAUSS_DRIFT_GROWTH from the first tenth of the run to the last.
+//GAUSS_DIVERGENT_h is too long a step for the stage equations to converge
+constexpr double GAUSS_ORDER_t_end = 10;
+constexpr double GAUSS_ORDER_h = 0.2;
+constexpr double GAUSS_ORDER_TOLERANCE = 0.1;
+constexpr double GAUSS_DRIFT_t_end = 10000;
+constexpr double GAUSS_DRIFT_h = 0.1;
+constexpr double GAUSS_DRIFT_BOUND[3] = {1e-4, 5e-8, 5e-12};
+constexpr double GAUSS_DRIFT_GROWTH = 1.1;
+constexpr double GAUSS_DIVERGENT_h = 4;
+
+//Taylor series method, the reference of the benchmark. Its columns agree within TAYLOR_REFERENCE_TOLERANCE
+//with sixth order Gauss-Legendre at TAYLOR_GAUSS_h up to TAYLOR_GAUSS_t_end (measured: 3e-14), and with
+//Kutta's method at TAYLOR_KUTTA_h up to TAYLOR_KUTTA_t_end (measured: 9e-14).
+//Runs to each of TAYLOR_END_t_end, most of them not a multiple of TAYLOR_END_h, have to store the same
+//columns as the fixed step methods and end exactly at t_end
+constexpr double TAYLOR_REFERENCE_TOLERANCE = 1e-12;
+constexpr double TAYLOR_GAUSS_t_end = 100;
+constexpr double TAYLOR_GAUSS_h = 0.01;
+constexpr double TAYLOR_KUTTA_t_end = 10;
+constexpr double TAYLOR_KUTTA_h = 0.001;
+constexpr double TAYLOR_END_t_end[5] = {0.25, 1.3, 7, 10.05, 99.99};
+constexpr double TAYLOR_END_h = 0.1;
+constexpr double TAYLOR_END_GAUSS_h = 0.001;
+
+//Time-transformed Störmer-Verlet. SUNDMAN_REVERSE_STEPS steps of SUNDMAN_REVERSE_ds and as many of
+//-SUNDMAN_REVERSE_ds have to return to the initial state within SUNDMAN_REVERSE_TOLERANCE (measured: 2.3e-12).
+//Up to SUNDMAN_DRIFT_t_end with SUNDMAN_DRIFT_ds the energy error stays below SUNDMAN_DRIFT_BOUND
+//(measured: 1.5e-4) and grows by at most SUNDMAN_DRIFT_GROWTH from the first tenth of the run to the last.
+//The interpolated output, against a Taylor series run, has to converge with order 2 from SUNDMAN_OUTPUT_ds
+//to SUNDMAN_OUTPUT_ds/2 (within SUNDMAN_OUTPUT_ORDER_TOLERANCE), with an error below SUNDMAN_OUTPUT_BOUND
+//at SUNDMAN_OUTPUT_ds/2 (measured: 3.4e-5).
+//The orbit from the origin with momentum SUNDMAN_ESCAPE_p2 (H = 0.2) leaves through the upper channel,
+//and reaches SUNDMAN_MAX_RADIUS before SUNDMAN_ESCAPE_t_end
+constexpr int SUNDMAN_REVERSE_STEPS = 10000;
+constexpr double SUNDMAN_REVERSE_ds = 0.05;
+constexpr double SUNDMAN_REVERSE_TOLERANCE = 1e-10;
+constexpr double SUNDMAN_DRIFT_t_end = 10000;
+constexpr double SUNDMAN_DRIFT_ds = 0.1;
+constexpr double SUNDMAN_DRIFT_dt_out = 1;
+constexpr double SUNDMAN_DRIFT_BOUND = 2e-4;
+constexpr double SUNDMAN_DRIFT_GROWTH = 1.1;
+constexpr double SUNDMAN_OUTPUT_t_end = 100;
+constexpr double SUNDMAN_OUTPUT_ds = 0.01;
+constexpr double SUNDMAN_OUTPUT_dt_out = 0.1;
+constexpr double SUNDMAN_OUTPUT_ORDER_TOLERANCE = 0.1;
+constexpr double SUNDMAN_OUTPUT_BOUND = 5e-5;
+constexpr double SUNDMAN_ESCAPE_p2 = 0.6324555320336759;
+constexpr double SUNDMAN_ESCAPE_t_end = 100;
+
+//Escape basins. The orbits from the origin towards each of the three saddles with energy ESCAPE_H_0
+//leave straight through that saddle's channel, at the same time up to ESCAPE_TIME_TOLERANCE (measured: 4.26).
+//The grid of ESCAPE_n_q2 x ESCAPE_n_p2 points up to ESCAPE_t_max has orbits leaving through every
+//channel at ESCAPE_H_0, and none at ESCAPE_TRAPPED_H_0 below the threshold 1/6
+constexpr double ESCAPE_H_0 = 0.2;
+constexpr double ESCAPE_TRAPPED_H_0 = 0.1;
+constexpr double ESCAPE_h = 0.01;
+constexpr double ESCAPE_t_max = 100;
+constexpr int ESCAPE_n_q2 = 20;
+constexpr int ESCAPE_n_p2 = 16;
+constexpr double ESCAPE_TIME_TOLERANCE = 1e-9;
@@ -0,0 +1,103 @@
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
+#include <cstring>
+#include <filesystem>
+#include <sys/wait.h>
+#include <thread>
+#include <unistd.h>
+
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief 
+ * Start a run with a checkpoint in a child process, and kill it while it runs
+ * 
+ * @param integrate Runs the method with a checkpoint file, integrate(file)
+ * @param file the checkpoint file
+ * @return true if the child was killed after writing a checkpoint
+ */
+template <typename Integrate>
+static bool kill_run(Integrate integrate, const std::string& file)
+{
+    pid_t child = fork();
+    if (child == 0)
+    {
+        integrate(file);
+        _exit(0);
+    }
+    if (child < 0)
+        return false;
+
+    //Wait for the first checkpoint, then let the run go on for a while before killing it
+    int status = 0;
+    while (!std::filesystem::exists(file))
+    {
+        if (waitpid(child, &status, WNOHANG) == child)
+            return false;
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+
+    bool running = (waitpid(child, &status, WNOHANG) == 0);
+    kill(child, SIGKILL);
+    waitpid(child, &status, 0);
+
+    return running && std::filesystem::exists(file);
+}
+
+/**
+ * @brief 
+ * Kill a run, resume it and compare it bitwise with a run that was never killed
+ * 
+ * @param name name of the method
+ * @param integrate Runs the method, integrate(file) (an empty file disables the checkpoint)
+ */
+template <typename Integrate>
+static void check_resume(const std::string& name, Integrate integrate)
+{
+    std::string file = "checkpoint_test_" + name + ".bin";
+    std::filesystem::remove(file);
+    std::filesystem::remove(file + ".cols");
+
+    Matrix<double, 4, Dynamic> Y_full = integrate(std::string());
+
+    bool killed = kill_run(integrate, file);
+    check(killed, name + " run killed after its first checkpoint");
+    if (!killed)
+        return;
+
+    Matrix<double, 4, Dynamic> Y_resumed = integrate(file);
+    check(Y_resumed.cols() == Y_full.cols() && !std::memcmp(Y_resumed.data(), Y_full.data(), Y_full.size()*sizeof(double)),
+        name + " resumed run bitwise identical to the full run");
+    check(!std::filesystem::exists(file) && !std::filesystem::exists(file + ".cols"), name + " checkpoint removed after the run");
+}
+
+/**
+ * Runs killed in the middle and resumed from their checkpoints
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+    setenv("HHP_CHECKPOINT_INTERVAL", CHECKPOINT_EVERY, 1);
+
+    check_resume("rk4", [&](const std::string& file) { return kuttas_method(0, CHECKPOINT_t_end, y0, GOLDEN_h, file); });
+    check_resume("sv", [&](const std::string& file) { return stormer_verlet(0, CHECKPOINT_t_end, y0, GOLDEN_h, file); });
+
+    //The cost of a resumed projected run only counts the steps and projections after its checkpoint
+    ProjectionStats stats;
+    auto projected = [&](const std::string& file)
+    {
+        stats = ProjectionStats();
+        return kuttas_method(0, CHECKPOINT_t_end, y0, GOLDEN_h, file, CHECKPOINT_PROJECT_EVERY, &stats);
+    };
+    projected(std::string());
+    ProjectionStats full = stats;
+    check_resume("rk4_projected", projected);
+    check(stats.steps > 0 && stats.steps < full.steps, "rk4_projected resumed run counts only its own steps");
+    check(stats.projections > 0 && stats.projections < full.projections, "rk4_projected resumed run counts only its own projections");
+
+    return failures;
+}
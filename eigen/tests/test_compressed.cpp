@@ -0,0 +1,112 @@
+#include <cstring>
+#include <filesystem>
+#include <limits>
+
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief
+ * Check that two matrices have the same size and the same bits (NaN included)
+ *
+ * @param A the computed matrix
+ * @param B the expected matrix
+ * @return bool true if they are the same
+ */
+static bool same_bits(const Ref<const Matrix<double, 4, Dynamic>> A, const Ref<const Matrix<double, 4, Dynamic>> B)
+{
+    if (A.cols() != B.cols())
+        return false;
+
+    for (Eigen::Index j = 0; j < A.cols(); j++)
+        if (std::memcmp(A.col(j).data(), B.col(j).data(), 4*sizeof(double)))
+            return false;
+
+    return true;
+}
+
+/**
+ * @brief
+ * Compress a matrix, and check that it comes back with the same bits from memory,
+ * from a file and from single blocks of the file
+ *
+ * @param Y the matrix
+ * @param what description of the matrix
+ * @return CompressedTrajectory the compressed matrix
+ */
+static CompressedTrajectory check_roundtrip(const Ref<const Matrix<double, 4, Dynamic>> Y, const std::string& what)
+{
+    CompressedTrajectory C = compress(Y);
+    check(compressed_cols(C) == Y.cols(), what + " columns");
+    check(compressed_blocks(C) == (Y.cols() + COMPRESSED_BLOCK - 1) / COMPRESSED_BLOCK, what + " blocks");
+    check(same_bits(decompress(C), Y), what + " decompressed");
+
+    save_compressed(COMPRESSED_FILE, C);
+    CompressedTrajectory C_file = load_compressed(COMPRESSED_FILE);
+    check(C_file.data == C.data && C_file.starts == C.starts && C_file.offsets == C.offsets, what + " loaded");
+
+    Matrix<double, 4, Dynamic> block(4, COMPRESSED_BLOCK);
+    for (int b = 0; b < compressed_blocks(C); b++)
+    {
+        int cols = load_compressed_block(COMPRESSED_FILE, b, block);
+        check(cols == C.starts[b+1] - C.starts[b] && same_bits(block.leftCols(cols), Y.middleCols(C.starts[b], cols)),
+            what + " block " + std::to_string(b) + " loaded");
+    }
+    check(load_compressed_block(COMPRESSED_FILE, compressed_blocks(C), block) == -1, what + " block past the end rejected");
+
+    std::filesystem::remove(COMPRESSED_FILE);
+    return C;
+}
+
+/**
+ * Compressed matrices decompress to the same bits, for every prediction order, across
+ * the boundaries of the blocks and with special values, and the compressed integrators
+ * store the same bits as the plain ones
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+    Matrix<double, 4, Dynamic> Y_sv = stormer_verlet(0, COMPRESSED_t_end, y0, GOLDEN_h);
+    check(Y_sv.cols() > 2*COMPRESSED_BLOCK && Y_sv.cols() % COMPRESSED_BLOCK, "run ends inside a later block");
+
+    //Special values, also at both sides of a block boundary
+    Matrix<double, 4, Dynamic> Y_special = Y_sv;
+    Y_special(3, 1) = std::numeric_limits<double>::quiet_NaN();
+    Y_special(3, COMPRESSED_BLOCK - 1) = -0.0;
+    Y_special(3, COMPRESSED_BLOCK) = std::numeric_limits<double>::infinity();
+    Y_special(3, COMPRESSED_BLOCK + 1) = -std::numeric_limits<double>::infinity();
+    Y_special(3, COMPRESSED_BLOCK + 2) = std::numeric_limits<double>::denorm_min();
+    Y_special(3, 2*COMPRESSED_BLOCK) = -std::numeric_limits<double>::max();
+    check_roundtrip(Y_special, "special values");
+
+    //A polynomial of degree order - 1 is predicted exactly by (only) the orders from order up,
+    //so the first row of every block is compressed with that order (orders 1 to 4)
+    for (int order = 1; order <= 4; order++)
+    {
+        Matrix<double, 4, Dynamic> Y = Y_sv;
+        for (Eigen::Index j = 0; j < Y.cols(); j++)
+            Y(0, j) = std::pow(double(j), order - 1);
+
+        std::string what = "order " + std::to_string(order);
+        CompressedTrajectory C = check_roundtrip(Y, what);
+        for (int b = 0; b < compressed_blocks(C); b++)
+            check(C.data[C.offsets[b]] == order, what + " chosen in block " + std::to_string(b));
+    }
+
+    //The compressed integrators, and the analyses that decompress them one block at a time
+    CompressedTrajectory C_sv = check_roundtrip(Y_sv, "sv");
+    check(C_sv.data.size() < Y_sv.size()*sizeof(double), "sv compressed smaller than stored");
+
+    check(same_bits(decompress(kuttas_method_compressed(0, COMPRESSED_t_end, y0, GOLDEN_h)), kuttas_method(0, COMPRESSED_t_end, y0, GOLDEN_h)), "rk4 compressed run");
+    check(same_bits(decompress(shampine_bogacki_compressed(0, COMPRESSED_t_end, y0, GOLDEN_h)), shampine_bogacki(0, COMPRESSED_t_end, y0, GOLDEN_h)), "sb compressed run");
+    check(same_bits(decompress(kahans_compressed(0, COMPRESSED_t_end, y0, GOLDEN_h)), kahans(0, COMPRESSED_t_end, y0, GOLDEN_h)), "kahans compressed run");
+    check(same_bits(decompress(stormer_verlet_compressed(0, COMPRESSED_t_end, y0, GOLDEN_h)), Y_sv), "sv compressed run");
+
+    check((hamiltonian(C_sv) == hamiltonian(Y_sv)).all(), "sv compressed hamiltonian");
+    Matrix<double, 2, Dynamic> P_sv = poincare(Y_sv);
+    Matrix<double, 2, Dynamic> P_compressed = poincare(C_sv);
+    check(P_compressed.cols() == P_sv.cols() && P_compressed == P_sv, "sv compressed Poincaré map");
+
+    return failures;
+}
@@ -0,0 +1,34 @@
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief 
+ * Largest energy drift max |H - H_0| of a computed matrix
+ */
+static double max_drift(const Ref<const Matrix<double, 4, Dynamic>> Y)
+{
+    Array<double, Dynamic, 1> H = hamiltonian(Y);
+    return (H - H[0]).abs().maxCoeff();
+}
+
+/**
+ * The energy drift of the methods that keep it bounded, and the projection at an equilibrium
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+
+    double drift_sv = max_drift(stormer_verlet(0, DRIFT_t_end, y0, GOLDEN_h));
+    check(drift_sv <= DRIFT_BOUND_sv, "sv energy drift " + std::to_string(drift_sv) + " within bound");
+
+    double drift_kahans = max_drift(kahans(0, DRIFT_t_end, y0, GOLDEN_h));
+    check(drift_kahans <= DRIFT_BOUND_kahans, "kahans energy drift " + std::to_string(drift_kahans) + " within bound");
+
+    //At the equilibrium in the origin the gradient of the energy vanishes, and the projection leaves it alone
+    Array<double, 4, 1> y_eq = Array<double, 4, 1>::Zero();
+    int iterations = project_energy(y_eq, GOLDEN_H_0);
+    check(iterations == 0 && (y_eq == 0).all(), "projection leaves an equilibrium unchanged");
+
+    return failures;
+}
@@ -0,0 +1,118 @@
+#include <cmath>
+#include <string>
+
+#include "../src/constants.h"
+#include "../src/problems/compute.h"
+#include "../src/problems/escape.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief
+ * Check the raster of an escape basin against its orbits run one at a time, and its statistics
+ * against the raster
+ *
+ * @param R the escape basin
+ * @param H_0 energy of its orbits
+ * @param what name of the basin in the messages
+ */
+static void check_basin(const EscapeResult& R, const double& H_0, const std::string& what)
+{
+    //Same grid as escape_basin
+    const double dq2 = (escape_q2[1] - escape_q2[0]) / (ESCAPE_n_q2 - 1);
+    const double dp2 = (escape_p2[1] - escape_p2[0]) / (ESCAPE_n_p2 - 1);
+
+    std::int64_t count[4] = {0, 0, 0, 0};
+    double mean_time[4] = {0, 0, 0, 0};
+    std::int64_t steps = 0;
+    int mismatches = 0;
+    for (int j = 0; j < ESCAPE_n_q2; j++)
+    {
+        for (int i = 0; i < ESCAPE_n_p2; i++)
+        {
+            double q2 = escape_q2[0] + j*dq2;
+            double p2 = escape_p2[0] + i*dp2;
+            double p1_sq = 2*H_0 - p2*p2 - q2*q2 + 2.0/3.0*q2*q2*q2;
+
+            int channel = ESCAPE_FORBIDDEN;
+            double t_escape = 0;
+            if (p1_sq >= 0)
+                channel = escape_orbit(Array<double, 4, 1>(std::sqrt(p1_sq), p2, 0, q2), ESCAPE_h, ESCAPE_t_max, t_escape);
+
+            if (R.channel(i, j) != channel || R.time(i, j) != t_escape)
+                mismatches++;
+            if (channel == ESCAPE_FORBIDDEN)
+                continue;
+
+            int outcome = (channel == ESCAPE_TRAPPED) ? 3 : channel;
+            count[outcome]++;
+            mean_time[outcome] += t_escape;
+            steps += std::int64_t(std::ceil(t_escape/ESCAPE_h - 0.5));
+        }
+    }
+    check(mismatches == 0, what + " raster matches the orbits run one at a time");
+
+    for (int outcome = 0; outcome < 4; outcome++)
+    {
+        std::string name = what + " outcome " + std::to_string(outcome);
+        check(R.count[outcome] == count[outcome], name + " count");
+        if (count[outcome])
+            check_close(R.mean_time[outcome], mean_time[outcome] / count[outcome], 1e-12 * ESCAPE_t_max, name + " mean escape time");
+    }
+    check(R.steps == steps, what + " steps");
+
+    //At least half of the escaped orbits leave by the median time, and at most half after it
+    std::int64_t escaped = count[0] + count[1] + count[2];
+    std::int64_t before = 0, after = 0;
+    for (std::int64_t k = 0; k < R.channel.size(); k++)
+    {
+        if (R.channel(k) < 0)
+            continue;
+        before += (R.time(k) <= R.median_time);
+        after += (R.time(k) > R.median_time);
+    }
+    check(2*before >= escaped && 2*after <= escaped, what + " median escape time");
+}
+
+/**
+ * The exit channels, orbits escaping through each saddle, and the escape basins with their statistics
+ */
+int main()
+{
+    //The saddles are at (0, 1) and (±sqrt(3)/2, -1/2)
+    const double s = std::sqrt(3.0)/2;
+    const double saddle[3][2] = {{0, 1}, {-s, -0.5}, {s, -0.5}};
+
+    //The lines from the origin to the saddles are symmetry axes of the potential, so an orbit
+    //from the origin along one of them stays on it and leaves through that saddle
+    double p = std::sqrt(2*ESCAPE_H_0);
+    double t_first = 0;
+    for (int c = 0; c < 3; c++)
+    {
+        std::string what = "channel " + std::to_string(c);
+        check(escape_channel(ESCAPE_RADIUS*saddle[c][0], ESCAPE_RADIUS*saddle[c][1]) == c, what + " of its saddle direction");
+
+        double t_escape;
+        int channel = escape_orbit(Array<double, 4, 1>(p*saddle[c][0], p*saddle[c][1], 0, 0), ESCAPE_h, ESCAPE_t_max, t_escape);
+        check(channel == c, what + " orbit towards its saddle");
+        check(t_escape > 0 && t_escape < ESCAPE_t_max, what + " orbit escapes before t_max");
+        if (c == 0)
+            t_first = t_escape;
+        check_close(t_escape, t_first, ESCAPE_TIME_TOLERANCE, what + " escape time equal to the other channels");
+    }
+
+    //Below the threshold energy no orbit leaves
+    double t_escape;
+    check(escape_orbit(create_init_cond(GOLDEN_H_0), ESCAPE_h, ESCAPE_t_max, t_escape) == ESCAPE_TRAPPED, "orbit below the threshold trapped");
+    check(t_escape == ESCAPE_t_max, "trapped orbit runs to t_max");
+
+    EscapeResult R = escape_basin(ESCAPE_H_0, ESCAPE_h, ESCAPE_t_max, ESCAPE_n_q2, ESCAPE_n_p2);
+    check_basin(R, ESCAPE_H_0, "basin above the threshold");
+    check(R.count[0] > 0 && R.count[1] > 0 && R.count[2] > 0, "basin above the threshold has orbits in every channel");
+
+    EscapeResult R_trapped = escape_basin(ESCAPE_TRAPPED_H_0, ESCAPE_h, ESCAPE_t_max, ESCAPE_n_q2, ESCAPE_n_p2);
+    check_basin(R_trapped, ESCAPE_TRAPPED_H_0, "basin below the threshold");
+    check(R_trapped.count[0] + R_trapped.count[1] + R_trapped.count[2] == 0 && R_trapped.count[3] > 0, "basin below the threshold is all trapped");
+
+    return failures;
+}
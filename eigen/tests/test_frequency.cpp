@@ -0,0 +1,40 @@
+#include <stdexcept>
+
+#include "../src/problems/frequency.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief 
+ * Check that the frequency analysis refuses a window
+ */
+static void check_rejected(const int& window)
+{
+    bool rejected = false;
+    try
+    {
+        compute_frequency("sv", 0, 100, create_init_cond(GOLDEN_H_0), GOLDEN_h, window);
+    }
+    catch (const std::invalid_argument&)
+    {
+        rejected = true;
+    }
+    check(rejected, "window of " + std::to_string(window) + " columns rejected");
+}
+
+/**
+ * The frequency of a pure tone, and windows that are not a positive power of two
+ */
+int main()
+{
+    std::vector<std::complex<double>> z(FREQUENCY_SAMPLES);
+    for (int j = 0; j < FREQUENCY_SAMPLES; j++)
+        z[j] = std::polar(1.0, FREQUENCY_omega*j*FREQUENCY_dt);
+    check_close(naff_frequency(z, FREQUENCY_dt), FREQUENCY_omega, FREQUENCY_TOLERANCE, "frequency of a pure tone");
+
+    check_rejected(0);
+    check_rejected(-1024);
+    check_rejected(1000);
+
+    return failures;
+}
@@ -0,0 +1,63 @@
+#include <functional>
+#include <stdexcept>
+
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+//A Gauss-Legendre method, run(t_end, h)
+typedef std::function<Matrix<double, 4, Dynamic>(const double&, const double&)> GaussRun;
+
+/**
+ * @brief
+ * Check the order of convergence, the bounded energy error and the rejection of a step
+ * that does not converge of a Gauss-Legendre method
+ *
+ * @param stages number of stages (the order is twice as large)
+ * @param run runs the method from the reference orbit, run(t_end, h)
+ * @param y_ref the state at GAUSS_ORDER_t_end
+ */
+static void check_gauss(const int& stages, const GaussRun& run, const Ref<const Array<double, 4, 1>> y_ref)
+{
+    std::string what = "gauss " + std::to_string(stages) + " stages";
+
+    Matrix<double, 4, Dynamic> Y_h = run(GAUSS_ORDER_t_end, GAUSS_ORDER_h);
+    Matrix<double, 4, Dynamic> Y_half = run(GAUSS_ORDER_t_end, GAUSS_ORDER_h/2);
+    double error_h = (Y_h.col(Y_h.cols() - 1).array() - y_ref).matrix().norm();
+    double error_half = (Y_half.col(Y_half.cols() - 1).array() - y_ref).matrix().norm();
+    check_close(std::log2(error_h / error_half), 2*stages, GAUSS_ORDER_TOLERANCE, what + " order");
+
+    Array<double, Dynamic, 1> E = (hamiltonian(run(GAUSS_DRIFT_t_end, GAUSS_DRIFT_h)) - GOLDEN_H_0).abs();
+    std::int64_t tenth = E.size() / 10;
+    check(E.maxCoeff() <= GAUSS_DRIFT_BOUND[stages - 1], what + " energy error " + std::to_string(E.maxCoeff()) + " within bound");
+    check(E.tail(tenth).maxCoeff() <= GAUSS_DRIFT_GROWTH * E.head(tenth).maxCoeff(), what + " energy error does not grow");
+
+    bool threw = false;
+    try
+    {
+        run(GAUSS_ORDER_t_end, GAUSS_DIVERGENT_h);
+    }
+    catch (const std::runtime_error&)
+    {
+        threw = true;
+    }
+    check(threw, what + " unconverged step rejected");
+}
+
+/**
+ * The implicit midpoint rule and the Gauss-Legendre methods of order 4 and 6
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+
+    //The Taylor series run only stores its end points
+    Matrix<double, 4, Dynamic> Y_ref = taylor(0, GAUSS_ORDER_t_end, y0, GAUSS_ORDER_t_end);
+    Array<double, 4, 1> y_ref = Y_ref.col(Y_ref.cols() - 1);
+
+    check_gauss(1, [&](const double& t_end, const double& h) { return implicit_midpoint(0, t_end, y0, h); }, y_ref);
+    check_gauss(2, [&](const double& t_end, const double& h) { return gauss_legendre_4(0, t_end, y0, h); }, y_ref);
+    check_gauss(3, [&](const double& t_end, const double& h) { return gauss_legendre_6(0, t_end, y0, h); }, y_ref);
+
+    return failures;
+}
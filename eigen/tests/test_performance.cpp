@@ -0,0 +1,88 @@
+#include <chrono>
+#include <cstdlib>
+#include <functional>
+#include <map>
+
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief 
+ * Time a run of an integrator, best of PERFORMANCE_REPEATS
+ * 
+ * @param run runs the integrator and returns the computed matrix
+ * @return double nanoseconds per step
+ */
+static double ns_per_step(const std::function<Matrix<double, 4, Dynamic>()>& run)
+{
+    double best = 0;
+    for (int k = 0; k < PERFORMANCE_REPEATS; k++)
+    {
+        auto start = std::chrono::steady_clock::now();
+        Matrix<double, 4, Dynamic> Y = run();
+        auto stop = std::chrono::steady_clock::now();
+
+        double ns = std::chrono::duration<double, std::nano>(stop - start).count() / (Y.cols() - 1);
+        best = (k == 0) ? ns : std::min(best, ns);
+    }
+
+    return best;
+}
+
+/**
+ * Timed runs of every integrator, compared to the ns/step stored in the baseline file
+ * (the first argument). Timings are kept per instruction set (see dispatch.h).
+ * Without a baseline for this instruction set, or with HHP_UPDATE_BASELINE set,
+ * the timings are stored as the new baseline instead, and the test is skipped
+ */
+int main(int argc, char** argv)
+{
+    std::string baseline_file = (argc > 1) ? argv[1] : "perf_baseline.txt";
+    const char* tolerance_env = std::getenv("HHP_PERF_TOLERANCE");
+    double tolerance = tolerance_env ? std::atof(tolerance_env) : PERFORMANCE_TOLERANCE;
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+
+    //The instruction set is part of the name, the kernels of each one have their own baseline
+    std::string isa = std::string("/") + isa_name(active_isa());
+    std::map<std::string, double> timings;
+    timings["rk4" + isa] = ns_per_step([&]() { return kuttas_method(0, PERFORMANCE_t_end, y0, GOLDEN_h); });
+    timings["sb" + isa] = ns_per_step([&]() { return shampine_bogacki(0, PERFORMANCE_t_end, y0, GOLDEN_h); });
+    timings["kahans" + isa] = ns_per_step([&]() { return kahans(0, PERFORMANCE_t_end, y0, GOLDEN_h); });
+    timings["sv" + isa] = ns_per_step([&]() { return stormer_verlet(0, PERFORMANCE_t_end, y0, GOLDEN_h); });
+
+    //Baseline of this machine, one "method/isa ns/step" per line
+    std::map<std::string, double> baseline;
+    std::ifstream in(baseline_file);
+    std::string name;
+    double ns;
+    while (in >> name >> ns)
+        baseline[name] = ns;
+    in.close();
+
+    bool update = std::getenv("HHP_UPDATE_BASELINE") != nullptr;
+    int compared = 0;
+    for (const auto& [name, time] : timings)
+    {
+        if (update || !baseline.count(name))
+        {
+            baseline[name] = time;
+            std::cout << name << ": " << time << " ns/step (stored as baseline)" << std::endl;
+            continue;
+        }
+
+        std::cout << name << ": " << time << " ns/step, baseline " << baseline[name] << std::endl;
+        check(time <= baseline[name] * (1 + tolerance), name + " ns/step regressed past the baseline");
+        compared++;
+    }
+
+    std::ofstream out(baseline_file, std::ios::trunc);
+    for (const auto& [name, time] : baseline)
+        out << name << " " << time << "\n";
+
+    //A run that only stored the baseline has checked nothing
+    if (!compared)
+        return PERFORMANCE_SKIPPED;
+
+    return failures;
+}
@@ -0,0 +1,43 @@
+#include "../src/problems/compute.h"
+#include "../src/problems/pipeline.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief
+ * Check that a method analysed while it is computed (as in compute_pipelined) gives the same bits
+ * as the hamiltonian and Poincaré map of its stored run (as in compute_both)
+ *
+ * @param method "rk4", "sb", "kahans" or "sv"
+ * @param Y the stored run of the method
+ * @param y0 initial condition
+ */
+static void check_pipeline(const std::string& method, const Ref<const Matrix<double, 4, Dynamic>> Y, const Ref<const Array<double, 4, 1>> y0)
+{
+    Array<double, Dynamic, 1> H_both(Y.cols());
+    hamiltonian(Y, H_both);
+    Matrix<double, 2, Dynamic> P_both = poincare(Y);
+
+    Array<double, Dynamic, 1> H(create_T(0, PIPELINE_t_end, GOLDEN_h).size());
+    Matrix<double, 2, Dynamic> P;
+    pipeline_method(method, 0, PIPELINE_t_end, y0, GOLDEN_h, H, P);
+
+    check(H.size() == H_both.size() && (H == H_both).all(), method + " pipelined hamiltonian");
+    check(P.cols() == P_both.cols() && P == P_both, method + " pipelined Poincaré map");
+}
+
+/**
+ * The hamiltonians and Poincaré maps of compute_pipelined are bitwise those of compute_both,
+ * for every integrator
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+
+    check_pipeline("rk4", kuttas_method(0, PIPELINE_t_end, y0, GOLDEN_h), y0);
+    check_pipeline("sb", shampine_bogacki(0, PIPELINE_t_end, y0, GOLDEN_h), y0);
+    check_pipeline("kahans", kahans(0, PIPELINE_t_end, y0, GOLDEN_h), y0);
+    check_pipeline("sv", stormer_verlet(0, PIPELINE_t_end, y0, GOLDEN_h), y0);
+
+    return failures;
+}
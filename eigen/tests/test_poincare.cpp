@@ -0,0 +1,74 @@
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief
+ * Check that the section q1 = 0 crossed upwards gives the same points as poincare()
+ *
+ * @param Y the computed run
+ * @param what name of the method
+ */
+static void check_section_poincare(const Ref<const Matrix<double, 4, Dynamic>> Y, const std::string& what)
+{
+    Array<double, 4, 1> normal(0, 0, 1, 0);
+    Matrix<double, 2, Dynamic> P = poincare(Y);
+    Matrix<double, 5, Dynamic> S = poincare_sections(Y, {create_section(normal, 0, SECTION_UP)})[0];
+
+    check(S.cols() == P.cols(), what + " section q1 = 0 crossings");
+    if (S.cols() == P.cols())
+    {
+        //poincare() stores (q2, p2)
+        check(S.row(3) == P.row(0), what + " section q1 = 0 q2");
+        check(S.row(1) == P.row(1), what + " section q1 = 0 p2");
+    }
+}
+
+/**
+ * The number of crossings of the Poincaré section by the reference orbit, for every integrator,
+ * and the crossings of other sections
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+
+    Matrix<double, 4, Dynamic> Y_rk = kuttas_method(0, POINCARE_t_end, y0, GOLDEN_h);
+    Matrix<double, 4, Dynamic> Y_sb = shampine_bogacki(0, POINCARE_t_end, y0, GOLDEN_h);
+    Matrix<double, 4, Dynamic> Y_kahans = kahans(0, POINCARE_t_end, y0, GOLDEN_h);
+    Matrix<double, 4, Dynamic> Y_sv = stormer_verlet(0, POINCARE_t_end, y0, GOLDEN_h);
+
+    check_close(poincare(Y_rk).cols(), POINCARE_CROSSINGS, POINCARE_TOLERANCE, "rk4 crossings");
+    check_close(poincare(Y_sb).cols(), POINCARE_CROSSINGS, POINCARE_TOLERANCE, "sb crossings");
+    check_close(poincare(Y_kahans).cols(), POINCARE_CROSSINGS, POINCARE_TOLERANCE, "kahans crossings");
+    check_close(poincare(Y_sv).cols(), POINCARE_CROSSINGS, POINCARE_TOLERANCE, "sv crossings");
+
+    check_section_poincare(Y_rk, "rk4");
+    check_section_poincare(Y_sb, "sb");
+    check_section_poincare(Y_kahans, "kahans");
+    check_section_poincare(Y_sv, "sv");
+
+    //Several sections found in one pass over many blocks give the same crossings as one section at a time
+    check(Y_sv.cols() > SECTION_BLOCK, "sections run longer than a block");
+
+    Section mixed = create_section(Array<double, 4, 1>(0.5, -0.25, 1, 0.75), 0.01, SECTION_DOWN);
+    mixed.energy = 2;
+    std::vector<Section> sections = {
+        create_section(Array<double, 4, 1>(0, 0, 1, 0), 0, SECTION_UP),
+        create_section(Array<double, 4, 1>(0, 0, 0, 1), 0, SECTION_BOTH),
+        create_energy_section(GOLDEN_H_0, SECTION_BOTH),
+        mixed
+    };
+
+    std::vector<Matrix<double, 5, Dynamic>> all = poincare_sections(Y_sv, sections);
+    check(all.size() == sections.size(), "sections count");
+    for (std::size_t k = 0; k < sections.size() && k < all.size(); k++)
+    {
+        Matrix<double, 5, Dynamic> alone = poincare_sections(Y_sv, {sections[k]})[0];
+        std::string what = "section " + std::to_string(k);
+
+        check(all[k].cols() > 0, what + " has crossings");
+        check(all[k].cols() == alone.cols() && all[k] == alone, what + " together and alone");
+    }
+
+    return failures;
+}
@@ -0,0 +1,97 @@
+#include <cmath>
+#include <stdexcept>
+#include <string>
+
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief
+ * Check that a run of the time-transformed Störmer-Verlet method rejects its arguments
+ *
+ * @param ds length of each step in the fictitious time
+ * @param dt_out time between each stored value
+ * @param y0 initial condition
+ */
+static void check_rejected(const double& ds, const double& dt_out, const Ref<const Array<double, 4, 1>> y0)
+{
+    bool threw = false;
+    try
+    {
+        sundman_sv(0, SUNDMAN_OUTPUT_t_end, y0, ds, dt_out);
+    }
+    catch (const std::invalid_argument&)
+    {
+        threw = true;
+    }
+    check(threw, "sundman_sv rejects ds = " + std::to_string(ds) + ", dt_out = " + std::to_string(dt_out));
+}
+
+/**
+ * The time-transformed Störmer-Verlet method: reversibility of its step, bounded energy error,
+ * the interpolated output, the end of escaping orbits and the rejection of bad arguments
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+
+    //Stepping back undoes the steps, including the auxiliary variable and the time
+    ForceRescaling R;
+    double g1, g2;
+    double W_0 = R.omega(y0[2], y0[3], g1, g2);
+    Array<double, 4, 1> y = y0;
+    double W = W_0;
+    double t = 0;
+    for (int i = 0; i < SUNDMAN_REVERSE_STEPS; i++)
+        sundman_sv_step(R, y, W, t, SUNDMAN_REVERSE_ds);
+    check(t > 0, "sundman_sv_step advances the time");
+    for (int i = 0; i < SUNDMAN_REVERSE_STEPS; i++)
+        sundman_sv_step(R, y, W, t, -SUNDMAN_REVERSE_ds);
+    check_close((y - y0).abs().maxCoeff(), 0, SUNDMAN_REVERSE_TOLERANCE, "sundman_sv_step reversed state");
+    check_close(W, W_0, SUNDMAN_REVERSE_TOLERANCE, "sundman_sv_step reversed W");
+    check_close(t, 0, SUNDMAN_REVERSE_TOLERANCE, "sundman_sv_step reversed time");
+
+    Array<double, Dynamic, 1> E = (hamiltonian(sundman_sv(0, SUNDMAN_DRIFT_t_end, y0, SUNDMAN_DRIFT_ds, SUNDMAN_DRIFT_dt_out)) - GOLDEN_H_0).abs();
+    std::int64_t tenth = E.size() / 10;
+    check(E.maxCoeff() <= SUNDMAN_DRIFT_BOUND, "sundman_sv energy error " + std::to_string(E.maxCoeff()) + " within bound");
+    check(E.tail(tenth).maxCoeff() <= SUNDMAN_DRIFT_GROWTH * E.head(tenth).maxCoeff(), "sundman_sv energy error does not grow");
+
+    //The Hermite output is at the same times as the Taylor series columns, and only adds an error
+    //smaller than the second order error of the steps
+    Matrix<double, 4, Dynamic> Y_ref = taylor(0, SUNDMAN_OUTPUT_t_end, y0, SUNDMAN_OUTPUT_dt_out);
+    Matrix<double, 4, Dynamic> Y_ds = sundman_sv(0, SUNDMAN_OUTPUT_t_end, y0, SUNDMAN_OUTPUT_ds, SUNDMAN_OUTPUT_dt_out);
+    Matrix<double, 4, Dynamic> Y_half = sundman_sv(0, SUNDMAN_OUTPUT_t_end, y0, SUNDMAN_OUTPUT_ds/2, SUNDMAN_OUTPUT_dt_out);
+    check(Y_ds.cols() == Y_ref.cols() && Y_half.cols() == Y_ref.cols(), "sundman_sv stores every dt_out");
+    if (Y_ds.cols() == Y_ref.cols() && Y_half.cols() == Y_ref.cols())
+    {
+        double error_ds = (Y_ds - Y_ref).cwiseAbs().maxCoeff();
+        double error_half = (Y_half - Y_ref).cwiseAbs().maxCoeff();
+        check_close(std::log2(error_ds / error_half), 2, SUNDMAN_OUTPUT_ORDER_TOLERANCE, "sundman_sv output order");
+        check(error_half <= SUNDMAN_OUTPUT_BOUND, "sundman_sv output error " + std::to_string(error_half) + " within bound");
+    }
+
+    //An escaping orbit is stored up to SUNDMAN_MAX_RADIUS, and nan after it
+    Array<double, 4, 1> y_escape;
+    y_escape << 0, SUNDMAN_ESCAPE_p2, 0, 0;
+    Matrix<double, 4, Dynamic> Y = sundman_sv(0, SUNDMAN_ESCAPE_t_end, y_escape, SUNDMAN_REVERSE_ds, SUNDMAN_OUTPUT_dt_out);
+    std::int64_t escaped = 0;
+    while (escaped < Y.cols() && !std::isnan(Y(0, escaped)))
+        escaped++;
+    check(escaped > 0 && escaped < Y.cols(), "sundman_sv escaping orbit ends before t_end");
+    if (escaped > 0 && escaped < Y.cols())
+    {
+        check(Y.rightCols(Y.cols() - escaped).array().isNaN().all(), "sundman_sv escaped orbit is nan after its end");
+        check(Y.leftCols(escaped).allFinite(), "sundman_sv escaping orbit is finite before its end");
+        double r = std::hypot(Y(2, escaped - 1), Y(3, escaped - 1));
+        check(r > 1 && r < SUNDMAN_MAX_RADIUS, "sundman_sv escaping orbit leaves the potential well");
+    }
+
+    check_rejected(0, SUNDMAN_OUTPUT_dt_out, y0);
+    check_rejected(-SUNDMAN_OUTPUT_ds, SUNDMAN_OUTPUT_dt_out, y0);
+    check_rejected(NAN, SUNDMAN_OUTPUT_dt_out, y0);
+    check_rejected(SUNDMAN_OUTPUT_ds, 0, y0);
+    check_rejected(SUNDMAN_OUTPUT_ds, -SUNDMAN_OUTPUT_dt_out, y0);
+
+    return failures;
+}
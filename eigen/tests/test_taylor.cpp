@@ -0,0 +1,54 @@
+#include <string>
+
+#include "../src/problems/compute.h"
+#include "golden.h"
+#include "test_utils.h"
+
+/**
+ * @brief
+ * Largest difference between two runs stored at the same times
+ *
+ * @param A first run
+ * @param B second run
+ * @return max |A - B|, or infinity if they store different numbers of columns
+ */
+static double max_difference(const Matrix<double, 4, Dynamic>& A, const Matrix<double, 4, Dynamic>& B)
+{
+    if (A.cols() != B.cols())
+        return INFINITY;
+
+    return (A - B).cwiseAbs().maxCoeff();
+}
+
+/**
+ * The Taylor series method against tight fixed step runs, and the end of its runs
+ */
+int main()
+{
+    Array<double, 4, 1> y0 = create_init_cond(GOLDEN_H_0);
+
+    double error = max_difference(taylor(0, TAYLOR_GAUSS_t_end, y0, TAYLOR_GAUSS_h), gauss_legendre_6(0, TAYLOR_GAUSS_t_end, y0, TAYLOR_GAUSS_h));
+    check(error <= TAYLOR_REFERENCE_TOLERANCE, "taylor against gauss_legendre_6, difference " + std::to_string(error));
+
+    error = max_difference(taylor(0, TAYLOR_KUTTA_t_end, y0, TAYLOR_KUTTA_h), kuttas_method(0, TAYLOR_KUTTA_t_end, y0, TAYLOR_KUTTA_h));
+    check(error <= TAYLOR_REFERENCE_TOLERANCE, "taylor against kuttas_method, difference " + std::to_string(error));
+
+    for (const double& t_end : TAYLOR_END_t_end)
+    {
+        std::string what = "taylor to t_end = " + std::to_string(t_end);
+
+        Matrix<double, 4, Dynamic> Y = taylor(0, t_end, y0, TAYLOR_END_h);
+        check(Y.cols() == create_T(0, t_end, TAYLOR_END_h).size(), what + " stores the columns of the fixed step methods");
+
+        //The steps do not depend on the output times, so the last column is the end point of a run
+        //that only stores its end points, to the bit
+        Matrix<double, 4, Dynamic> Y_end = taylor(0, t_end, y0, t_end);
+        check(Y.col(Y.cols() - 1) == Y_end.col(Y_end.cols() - 1), what + " ends at the end point of the run");
+
+        Matrix<double, 4, Dynamic> Y_ref = gauss_legendre_6(0, t_end, y0, TAYLOR_END_GAUSS_h);
+        error = (Y.col(Y.cols() - 1) - Y_ref.col(Y_ref.cols() - 1)).cwiseAbs().maxCoeff();
+        check(error <= TAYLOR_REFERENCE_TOLERANCE, what + " ends at t_end, difference " + std::to_string(error));
+    }
+
+    return failures;
+}
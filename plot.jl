@@ -195,6 +195,54 @@ function poincare_all_methods(h_arr, labels, fig_names)
     end
 end
 
+function plot_work_precision(wp_file, fig_name)
+    #Plot the global error of every method against its cost (rhs evaluations and wall time)
+    #The table is computed with ./hhp benchmark, see ./eigen/src/problems/benchmark.h
+
+    # Size of plot
+    fig_size = (1000,500)
+
+    #Columns: method, h (tolerance of the Taylor series method), steps, rhs evaluations, wall time,
+    #global error, energy error, Newton iterations and time of the projections (of the projected methods 4 and 5)
+    df = Matrix(CSV.read(wp_file, DataFrame; header = 0))
+    labels = ["Kutta's method", "Shampine-Bogacki method", "Kahan's method", "Störmer-Verlet method",
+        "Kutta's method (projected)", "Shampine-Bogacki method (projected)", "Implicit midpoint rule",
+        "Gauss-Legendre method (order 4)", "Gauss-Legendre method (order 6)", "Taylor series method",
+        "Sundman method"]
+
+    p1 = plot(xscale = :log10, yscale = :log10, legend = :bottomleft)
+    p2 = plot(xscale = :log10, yscale = :log10, legend = false)
+    for method in 0:10
+        rows = df[df[:,1] .== method, :]
+        plot!(p1, rows[:,4], rows[:,6], label = labels[method+1], markershape = :circle)
+        plot!(p2, rows[:,5], rows[:,6], markershape = :circle)
+    end
+    xlabel!(p1, "RHS evaluations")
+    xlabel!(p2, "Wall time [s]")
+    ylabel!(p1, "Global error")
+
+    plot(p1, p2, layout = (1,2), plot_title = "Work-precision diagram", size = fig_size)
+    savefig(fig_name)
+end
+
+function plot_escape_basin(basin_file, fig_name)
+    #Plot the exit channel of every initial condition on the section q1 = 0
+    #The basins are computed with ./hhp escape, see ./eigen/src/problems/escape.h
+
+    # Size of plot
+    fig_size = (800,600)
+
+    #Rows p2, columns q2, the ranges are escape_q2 and escape_p2 in ./eigen/src/constants.h
+    #Values: 0 upper, 1 lower left, 2 lower right channel, -1 trapped, -2 forbidden
+    basin = Matrix(CSV.read(basin_file, DataFrame; header = 0))
+    q2 = range(-0.8, 1.2, length = size(basin, 2))
+    p2 = range(-0.8, 0.8, length = size(basin, 1))
+
+    heatmap(q2, p2, basin, color = cgrad(:viridis, 5, categorical = true), clims = (-2, 2),
+        xlabel = "q2", ylabel = "p2", title = "Escape basins", size = fig_size)
+    savefig(fig_name)
+end
+
 #Folder for storing plots
 output_folder = "./$(num_lib)/plots"
 mkpath(output_folder)
@@ -214,4 +262,16 @@ for (t, h) in zip(t_arr, h_arr)
     append!(labels, "T = $(t)s & h = $(h)s")
 end
 
-poincare_all_methods(h_arr, labels, fig_names)
\ No newline at end of file
+poincare_all_methods(h_arr, labels, fig_names)
+
+#The work-precision diagram, if the benchmark has been run
+wp_file = "./$(num_lib)/output/work_precision.csv"
+if isfile(wp_file)
+    plot_work_precision(wp_file, "$(output_folder)/work_precision.png")
+end
+
+#The escape basins, if they have been computed
+basin_file = "./$(num_lib)/output/escape_basin.csv"
+if isfile(basin_file)
+    plot_escape_basin(basin_file, "$(output_folder)/escape_basin.png")
+end